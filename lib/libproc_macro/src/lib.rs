@@ -176,6 +176,9 @@ pub fn main(macros: &[MacroDesc])
     //::env_logger::init();
 
     let mac_name = ::std::env::args().nth(1).expect("Was not passed a macro name");
+    if mac_name == "--server" {
+        return run_server(macros);
+    }
     //eprintln!("Searching for macro {}\r", mac_name);
     for m in macros
     {
@@ -197,3 +200,37 @@ pub fn main(macros: &[MacroDesc])
     panic!("Unknown macro name '{}'", mac_name);
 }
 
+/// Server mode: handle a sequence of invocations (each preceded by the macro name) until the
+/// compiler closes stdin.
+fn run_server(macros: &[MacroDesc])
+{
+    use std::io::Write;
+    let stdin = ::std::io::stdin();
+    let stdout = ::std::io::stdout();
+    // Indicate that server mode is supported
+    stdout.lock().write(&[0]).expect("Stdout write error?");
+    stdout.lock().flush().expect("Stdout write error?");
+    while let Some(mac_name) = crate::serialisation::recv_macro_name(stdin.lock())
+    {
+        match macros.iter().find(|m| m.name == mac_name)
+        {
+        Some(m) => {
+            stdout.lock().write(&[0]).expect("Stdout write error?");
+            stdout.lock().flush().expect("Stdout write error?");
+            debug!("Waiting for input to {}\r", mac_name);
+            let input = crate::serialisation::recv_token_stream(stdin.lock());
+            debug!("INPUT = `{}`\r", input);
+            let output = (m.handler)( input );
+            debug!("OUTPUT = `{}`\r", output);
+            crate::serialisation::send_token_stream(stdout.lock(), output);
+            stdout.lock().flush().expect("Stdout write error?");
+            },
+        None => {
+            // Unknown macro, report failure and wait for the next request
+            stdout.lock().write(&[1]).expect("Stdout write error?");
+            stdout.lock().flush().expect("Stdout write error?");
+            },
+        }
+    }
+    note!("Done");
+}
@@ -3,6 +3,17 @@ use crate::*;
 use crate::protocol::Token;
 use crate::protocol::{Reader,Writer};
 
+/// Receive the name of the next macro to invoke (server mode), `None` once the compiler closes the stream
+pub fn recv_macro_name<R: ::std::io::Read>(reader: R) -> Option<String>
+{
+    match Reader::new(reader).read_ent()
+    {
+    None => None,
+    Some(Token::Ident(name)) => Some(name),
+    Some(_) => panic!("Expected a macro name from the compiler"),
+    }
+}
+
 /// Receive a token stream from the compiler
 pub fn recv_token_stream<R: ::std::io::Read>(reader: R) -> TokenStream
 {
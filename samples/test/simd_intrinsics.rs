@@ -0,0 +1,110 @@
+// compile-flags: --test
+//! `repr(simd)` intrinsics, covering both the vector-extension lowering (power-of-two lane counts) and the
+//! scalar fallback (three lanes)
+#![feature(repr_simd, platform_intrinsics)]
+
+#[repr(simd)]
+#[derive(Copy,Clone)]
+struct i32x4(i32, i32, i32, i32);
+#[repr(simd)]
+#[derive(Copy,Clone)]
+struct f32x4(f32, f32, f32, f32);
+#[repr(simd)]
+#[derive(Copy,Clone)]
+struct u32x3(u32, u32, u32);
+
+extern "platform-intrinsic" {
+    fn simd_add<T>(a: T, b: T) -> T;
+    fn simd_sub<T>(a: T, b: T) -> T;
+    fn simd_mul<T>(a: T, b: T) -> T;
+    fn simd_eq<T, U>(a: T, b: T) -> U;
+    fn simd_lt<T, U>(a: T, b: T) -> U;
+    fn simd_insert<T, E>(a: T, idx: u32, v: E) -> T;
+    fn simd_extract<T, E>(a: T, idx: u32) -> E;
+    fn simd_shuffle3<T, U>(a: T, b: T, idx: [u32; 3]) -> U;
+    fn simd_shuffle4<T, U>(a: T, b: T, idx: [u32; 4]) -> U;
+}
+
+// Kept out of line so the operations are done on runtime values
+#[inline(never)]
+fn i4(a: i32, b: i32, c: i32, d: i32) -> i32x4 { i32x4(a, b, c, d) }
+#[inline(never)]
+fn f4(a: f32, b: f32, c: f32, d: f32) -> f32x4 { f32x4(a, b, c, d) }
+#[inline(never)]
+fn u3(a: u32, b: u32, c: u32) -> u32x3 { u32x3(a, b, c) }
+
+#[test]
+fn arithmetic()
+{
+    let a = i4(1, -2, 3, i32::max_value());
+    let b = i4(10, 20, -30, 1);
+    let r: i32x4 = unsafe { simd_add(a, b) };
+    assert_eq!( (r.0, r.1, r.2, r.3), (11, 18, -27, i32::min_value()) );
+    let r: i32x4 = unsafe { simd_sub(a, b) };
+    assert_eq!( (r.0, r.1, r.2, r.3), (-9, -22, 33, i32::max_value() - 1) );
+    let r: i32x4 = unsafe { simd_mul(a, b) };
+    assert_eq!( (r.0, r.1, r.2, r.3), (10, -40, -90, i32::max_value()) );
+
+    let r: f32x4 = unsafe { simd_add(f4(1.0, 2.0, 3.0, 4.0), f4(0.5, 0.25, -3.0, 4.0)) };
+    assert_eq!( (r.0, r.1, r.2, r.3), (1.5, 2.25, 0.0, 8.0) );
+
+    let x = u3(2, 3, 0xFFFF_FFFF);
+    let y = u3(5, 1, 2);
+    let r: u32x3 = unsafe { simd_add(x, y) };
+    assert_eq!( (r.0, r.1, r.2), (7, 4, 1) );
+    let r: u32x3 = unsafe { simd_mul(x, y) };
+    assert_eq!( (r.0, r.1, r.2), (10, 3, 0xFFFF_FFFE) );
+}
+
+#[test]
+fn comparisons()
+{
+    // True lanes are all-ones
+    let a = f4(1.0, 2.0, 3.0, 4.0);
+    let b = f4(4.0, 2.0, 2.0, 5.0);
+    let r: i32x4 = unsafe { simd_eq(a, b) };
+    assert_eq!( (r.0, r.1, r.2, r.3), (0, -1, 0, 0) );
+    let r: i32x4 = unsafe { simd_lt(a, b) };
+    assert_eq!( (r.0, r.1, r.2, r.3), (-1, 0, 0, -1) );
+
+    let r: i32x4 = unsafe { simd_lt(i4(-1, 0, 1, 2), i4(0, 0, 0, 3)) };
+    assert_eq!( (r.0, r.1, r.2, r.3), (-1, 0, 0, -1) );
+
+    let x = u3(2, 3, 4);
+    let y = u3(5, 3, 1);
+    let r: u32x3 = unsafe { simd_eq(x, y) };
+    assert_eq!( (r.0, r.1, r.2), (0, !0, 0) );
+    let r: u32x3 = unsafe { simd_lt(x, y) };
+    assert_eq!( (r.0, r.1, r.2), (!0, 0, 0) );
+}
+
+#[test]
+fn insert_extract()
+{
+    let a = i4(10, 11, 12, 13);
+    let r: i32x4 = unsafe { simd_insert(a, 2, 99i32) };
+    assert_eq!( (r.0, r.1, r.2, r.3), (10, 11, 99, 13) );
+    let v: i32 = unsafe { simd_extract(a, 3) };
+    assert_eq!(v, 13);
+
+    let x = u3(1, 2, 3);
+    let r: u32x3 = unsafe { simd_insert(x, 0, 7u32) };
+    assert_eq!( (r.0, r.1, r.2), (7, 2, 3) );
+    let v: u32 = unsafe { simd_extract(x, 2) };
+    assert_eq!(v, 3);
+}
+
+#[test]
+fn shuffles()
+{
+    // Indexes below the lane count select from the first input, the rest from the second
+    let p = i4(10, 11, 12, 13);
+    let q = i4(20, 21, 22, 23);
+    let r: i32x4 = unsafe { simd_shuffle4(p, q, [7, 0, 5, 2]) };
+    assert_eq!( (r.0, r.1, r.2, r.3), (23, 10, 21, 12) );
+
+    let x = u3(1, 2, 3);
+    let y = u3(4, 5, 6);
+    let r: u32x3 = unsafe { simd_shuffle3(x, y, [5, 1, 3]) };
+    assert_eq!( (r.0, r.1, r.2), (6, 2, 4) );
+}
@@ -184,6 +184,47 @@ enum class FragType
     Block = 6,
     Pattern = 7,
 };
+/// Pipes to a running proc-macro executable
+///
+/// Either started for a single invocation (`<exe> <macro_name>`), or as a server
+/// (`<exe> --server`) that handles a sequence of invocations, each preceded by the macro name.
+struct ProcMacroChild
+{
+#ifdef _WIN32
+    HANDLE  child_handle;
+    HANDLE  child_stdin;
+    HANDLE  child_stdout;
+#else
+    // POSIX
+    pid_t   child_pid;  // Questionably needed
+     int    child_stdin;
+     int    child_stdout;
+    // NOTE: stderr stays as our stderr
+#endif
+    bool    is_server;
+    /// Set while an invocation is using this (server) child
+    bool    in_use = false;
+    /// Set if an invocation didn't read all of its output, leaving the stream unusable
+    bool    is_broken = false;
+
+    /// Outgoing data, written to the pipe in one go by `flush`
+    ::std::vector<uint8_t>  send_buf;
+    uint8_t recv_buf[4096];
+    size_t  recv_ofs = 0;
+    size_t  recv_len = 0;
+
+    ProcMacroChild(const Span& sp, const char* executable, const char* arg, bool is_server);
+    ProcMacroChild(const ProcMacroChild&) = delete;
+    ProcMacroChild& operator=(const ProcMacroChild&) = delete;
+    ~ProcMacroChild();
+
+    /// Read the single status byte sent by the child (zero if it's ready for input)
+    bool check_good();
+    void flush(const Span& sp);
+    /// Read `len` bytes, returns false on EOF/error
+    bool recv(void* out, size_t len);
+};
+
 struct ProcMacroInv:
     public TokenStream
 {
@@ -193,30 +234,11 @@ struct ProcMacroInv:
     ::std::ofstream m_dump_file_out;
     ::std::ofstream m_dump_file_res;
 
-    struct Handles
-    {
-        //~Handles();
-        Handles() {}
-        Handles(Handles&&);
-        Handles(const Handles&) = delete;
-        Handles& operator=(Handles&&) = delete;
-        Handles& operator=(const Handles&) = delete;
-#ifdef _WIN32
-        HANDLE  child_handle;
-        HANDLE  child_stdin;
-        HANDLE  child_stdout;
-#else
-        // POSIX
-        pid_t   child_pid;  // Questionably needed
-         int    child_stdin;
-         int    child_stdout;
-        // NOTE: stderr stays as our stderr
-#endif
-    } handles;
+    ::std::shared_ptr<ProcMacroChild>   m_child;
     bool    m_eof_hit = false;
 
 public:
-    ProcMacroInv(const Span& sp, AST::Edition edition, const char* executable, const ::HIR::ProcMacro& proc_macro_desc);
+    ProcMacroInv(const Span& sp, AST::Edition edition, ::std::shared_ptr<ProcMacroChild> child, const ::HIR::ProcMacro& proc_macro_desc);
     ProcMacroInv(const ProcMacroInv&) = delete;
     ProcMacroInv(ProcMacroInv&&) = default;
     ProcMacroInv& operator=(const ProcMacroInv&) = delete;
@@ -226,6 +248,7 @@ public:
     bool check_good();
     void send_done() {
         send_symbol("");
+        m_child->flush(m_parent_span);
         DEBUG("Input tokens sent");
     }
     void send_symbol(const char* val) {
@@ -356,8 +379,43 @@ ProcMacroInv ProcMacro_Invoke_int(const Span& sp, const ::AST::Crate& crate, con
     // TODO: Windows will have .exe?
     ::std::string   proc_macro_exe_name = ext_crate.m_filename;
 
-    // 3. Create ProcMacroInv
-    auto rv = ProcMacroInv(sp, crate.m_edition, proc_macro_exe_name.c_str(), *pmp);
+    // 3. Get a child process to run the macro
+    // - Prefer a long-running server for the crate (started on first use), falling back to a process per invocation if
+    //   the executable doesn't support server mode, or the server is still busy with another invocation.
+    static ::std::map< ::std::string, ::std::shared_ptr<ProcMacroChild> >   s_servers;
+    static bool s_servers_disabled = getenv("MRUSTC_PROCMACRO_NO_SERVER") != nullptr;
+    ::std::shared_ptr<ProcMacroChild>   child;
+    if( !s_servers_disabled )
+    {
+        auto it = s_servers.find(proc_macro_exe_name);
+        if( it != s_servers.end() && it->second && it->second->is_broken )
+        {
+            DEBUG("Restarting broken proc-macro server for " << proc_macro_exe_name);
+            s_servers.erase(it);
+            it = s_servers.end();
+        }
+        if( it == s_servers.end() )
+        {
+            auto server = ::std::make_shared<ProcMacroChild>(sp, proc_macro_exe_name.c_str(), "--server", true);
+            if( !server->check_good() )
+            {
+                DEBUG(proc_macro_exe_name << " doesn't support server mode");
+                server.reset();
+            }
+            it = s_servers.insert(::std::make_pair(proc_macro_exe_name, mv$(server))).first;
+        }
+        if( it->second && !it->second->in_use )
+        {
+            child = it->second;
+        }
+    }
+    if( !child )
+    {
+        child = ::std::make_shared<ProcMacroChild>(sp, proc_macro_exe_name.c_str(), pmp->name.c_str(), false);
+    }
+
+    // 4. Create ProcMacroInv
+    auto rv = ProcMacroInv(sp, crate.m_edition, mv$(child), *pmp);
     rv.parse_state().crate = &crate;
     return rv;
 
@@ -1205,11 +1263,12 @@ namespace {
     return box$(pmi);
 }
 
-ProcMacroInv::ProcMacroInv(const Span& sp, AST::Edition edition, const char* executable, const ::HIR::ProcMacro& proc_macro_desc):
+ProcMacroInv::ProcMacroInv(const Span& sp, AST::Edition edition, ::std::shared_ptr<ProcMacroChild> child, const ::HIR::ProcMacro& proc_macro_desc):
     TokenStream(ParseState()),
     m_parent_span(sp),
     m_proc_macro_desc(proc_macro_desc),
-    m_edition(edition)
+    m_edition(edition),
+    m_child(mv$(child))
 {
     // TODO: Optionally dump the data sent to the client.
     if( getenv("MRUSTC_DUMP_PROCMACRO") )
@@ -1227,8 +1286,18 @@ ProcMacroInv::ProcMacroInv(const Span& sp, AST::Edition edition, const char* exe
     {
         DEBUG("Set MRUSTC_DUMP_PROCMACRO=dump_prefix to dump to `dump_prefix-NNN-{out,res}.bin`");
     }
+    if( m_child->is_server )
+    {
+        // Select the macro to run
+        m_child->in_use = true;
+        this->send_ident(proc_macro_desc.name.c_str());
+    }
+}
+ProcMacroChild::ProcMacroChild(const Span& sp, const char* executable, const char* arg, bool is_server):
+    is_server(is_server)
+{
 #ifdef _WIN32
-    std::string commandline = std::string{ executable } + " " + proc_macro_desc.name.c_str();
+    std::string commandline = std::string{ executable } + " " + arg;
     DEBUG(commandline);
 
     HANDLE stdin_read = INVALID_HANDLE_VALUE;
@@ -1274,9 +1343,9 @@ ProcMacroInv::ProcMacroInv(const Span& sp, AST::Edition edition, const char* exe
         BUG(sp, "Error in CreateProcessW - " << GetLastError() << " - can't start `" << executable << "`");
     }
 
-    this->handles.child_stdin = stdin_write;
-    this->handles.child_stdout = stdout_read;
-    this->handles.child_handle = piProcInfo.hProcess;
+    this->child_stdin = stdin_write;
+    this->child_stdout = stdout_read;
+    this->child_handle = piProcInfo.hProcess;
 
     // Close the handles we don't care about.
     CloseHandle(stdin_read);
@@ -1288,13 +1357,13 @@ ProcMacroInv::ProcMacroInv(const Span& sp, AST::Edition edition, const char* exe
     {
         BUG(sp, "Unable to create stdin pipe pair for proc macro, " << strerror(errno));
     }
-    this->handles.child_stdin = stdin_pipes[1]; // Write end
+    this->child_stdin = stdin_pipes[1]; // Write end
      int    stdout_pipes[2];
     if( pipe(stdout_pipes) != 0)
     {
         BUG(sp, "Unable to create stdout pipe pair for proc macro, " << strerror(errno));
     }
-    this->handles.child_stdout = stdout_pipes[0]; // Read end
+    this->child_stdout = stdout_pipes[0]; // Read end
 
     posix_spawn_file_actions_t  file_actions;
     posix_spawn_file_actions_init(&file_actions);
@@ -1305,10 +1374,10 @@ ProcMacroInv::ProcMacroInv(const Span& sp, AST::Edition edition, const char* exe
     posix_spawn_file_actions_addclose(&file_actions, stdout_pipes[0]);
     posix_spawn_file_actions_addclose(&file_actions, stdout_pipes[1]);
 
-    char*   argv[3] = { const_cast<char*>(executable), const_cast<char*>(proc_macro_desc.name.c_str()), nullptr };
+    char*   argv[3] = { const_cast<char*>(executable), const_cast<char*>(arg), nullptr };
     DEBUG(argv[0] << " " << argv[1]);
     //char*   envp[] = { nullptr };
-    int rv = posix_spawn(&this->handles.child_pid, executable, &file_actions, nullptr, argv, environ);
+    int rv = posix_spawn(&this->child_pid, executable, &file_actions, nullptr, argv, environ);
     if( rv != 0 )
     {
         BUG(sp, "Error in posix_spawn - " << rv << " - can't start `" << executable << "`");
@@ -1321,99 +1390,117 @@ ProcMacroInv::ProcMacroInv(const Span& sp, AST::Edition edition, const char* exe
 
 #endif
 }
-ProcMacroInv::Handles::Handles(Handles&& x):
-#ifdef _WIN32
-    child_handle(x.child_handle),
-    child_stdin(x.child_stdin),
-    child_stdout(x.child_stdout)
-#else
-    child_pid(x.child_pid),
-    child_stdin(x.child_stdin),
-    child_stdout(x.child_stdout)
-#endif
+ProcMacroChild::~ProcMacroChild()
 {
+    // Close the pipes before waiting, so the child exits (a server is waiting for another request, and a child that's
+    // still producing output gets a write error)
 #ifdef _WIN32
-    x.child_handle = INVALID_HANDLE_VALUE;
-    x.child_stdin = INVALID_HANDLE_VALUE;
-    x.child_stdout = INVALID_HANDLE_VALUE;
+    if( this->child_handle != INVALID_HANDLE_VALUE )
+    {
+        CloseHandle(this->child_stdin);
+        CloseHandle(this->child_stdout);
+        WaitForSingleObject(this->child_handle, INFINITE);
+        CloseHandle(this->child_handle);
+    }
 #else
-    x.child_pid = 0;
-    x.child_stdin = -1;
-    x.child_stdout = -1;
+    if( this->child_pid != 0 )
+    {
+        close(this->child_stdin);
+        close(this->child_stdout);
+        int status;
+        waitpid(this->child_pid, &status, 0);
+    }
 #endif
-    DEBUG("");
 }
-#if 0
-ProcMacroInv::Handles& ProcMacroInv::Handles::operator=(Handles&& x)
+bool ProcMacroChild::check_good()
 {
-#ifdef _WIN32
-    child_handle = x.child_handle;
-    child_stdin  = x.child_stdin;
-    child_stdout = x.child_stdout;
-    x.child_handle = INVALID_HANDLE_VALUE;
-    x.child_stdin = INVALID_HANDLE_VALUE;
-    x.child_stdout = INVALID_HANDLE_VALUE;
-#else
-    child_pid = x.child_pid;
-    child_stdin = x.child_stdin;
-    child_stdout = x.child_stdout;
-
-    x.child_pid = 0;
-#endif
-    DEBUG("");
-    return *this;
+    uint8_t v;
+    if( !this->recv(&v, 1) )
+    {
+        DEBUG("Unexpected EOF from child");
+        is_broken = true;
+        return false;
+    }
+    DEBUG("Child started, value = " << (int)v);
+    if( v != 0 )
+        return false;
+    return true;
 }
-#endif
-ProcMacroInv::~ProcMacroInv()
+void ProcMacroChild::flush(const Span& sp)
 {
+    if( send_buf.empty() )
+        return ;
 #ifdef _WIN32
-    if( this->handles.child_handle != INVALID_HANDLE_VALUE )
-    {
-        DEBUG("Waiting for child to terminate");
-        WaitForSingleObject(this->handles.child_handle, INFINITE);
-        CloseHandle(this->handles.child_stdout);
-        CloseHandle(this->handles.child_stdin);
-        CloseHandle(this->handles.child_handle);
-    }
+    DWORD bytesWritten = 0;
+    if( !WriteFile(this->child_stdin, send_buf.data(), send_buf.size(), &bytesWritten, nullptr) || bytesWritten != send_buf.size() )
+        BUG(sp, "Error writing to child, " << GetLastError());
 #else
-    if( this->handles.child_pid != 0 )
+    size_t ofs = 0;
+    while( ofs < send_buf.size() )
     {
-        DEBUG("Waiting for child " << this->handles.child_pid << " to terminate");
-        int status;
-        waitpid(this->handles.child_pid, &status, 0);
-        close(this->handles.child_stdout);
-        close(this->handles.child_stdin);
+        auto n = write(this->child_stdin, send_buf.data() + ofs, send_buf.size() - ofs);
+        if( n <= 0 )
+            BUG(sp, "Error writing to child, " << strerror(errno));
+        ofs += n;
     }
 #endif
+    send_buf.clear();
 }
-bool ProcMacroInv::check_good()
+bool ProcMacroChild::recv(void* out_void, size_t len)
 {
-    char    v;
-#ifdef _WIN32
-    DWORD rv = 0;
-    if( !ReadFile(this->handles.child_stdout, &v, 1, &rv, nullptr) )
+    uint8_t* val = reinterpret_cast<uint8_t*>(out_void);
+    while( len > 0 )
     {
-        DEBUG("Error reading from child, " << GetLastError());
-        return false;
-    }
+        if( recv_ofs == recv_len )
+        {
+#ifdef _WIN32
+            DWORD n = 0;
+            if( !ReadFile(this->child_stdout, recv_buf, sizeof(recv_buf), &n, nullptr) )
+            {
+                DEBUG("Error reading from child, " << GetLastError());
+                return false;
+            }
 #else
-    int rv = read(this->handles.child_stdout, &v, 1);
+            auto n = read(this->child_stdout, recv_buf, sizeof(recv_buf));
+            if( n < 0 )
+            {
+                DEBUG("Error reading from child, rv=" << n << " " << strerror(errno));
+                return false;
+            }
 #endif
-    if( rv == 0 )
+            if( n == 0 )
+                return false;
+            recv_ofs = 0;
+            recv_len = n;
+        }
+        size_t n = ::std::min(len, recv_len - recv_ofs);
+        ::std::memcpy(val, recv_buf + recv_ofs, n);
+        recv_ofs += n;
+        val += n;
+        len -= n;
+    }
+    return true;
+}
+
+ProcMacroInv::~ProcMacroInv()
+{
+    if( m_child && m_child->is_server )
     {
-        DEBUG("Unexpected EOF from child");
-        return false;
+        // If the output wasn't fully read, the rest of it is still in the pipe
+        if( !m_eof_hit )
+            m_child->is_broken = true;
+        m_child->in_use = false;
     }
-#ifndef _WIN32
-    if( rv < 0 )
+}
+bool ProcMacroInv::check_good()
+{
+    m_child->flush(m_parent_span);
+    if( !m_child->check_good() )
     {
-        DEBUG("Error reading from child, rv=" << rv << " " << strerror(errno));
+        // No output will be sent, so a server can still be used for later invocations
+        m_eof_hit = true;
         return false;
     }
-#endif
-    DEBUG("Child started, value = " << (int)v);
-    if( v != 0 )
-        return false;
     return true;
 }
 void ProcMacroInv::send_u8(uint8_t v)
@@ -1429,14 +1516,8 @@ void ProcMacroInv::send_bytes_raw(const void* val, size_t size)
 {
     if( m_dump_file_out.is_open() )
         m_dump_file_out.write( reinterpret_cast<const char*>(val), size);
-#ifdef _WIN32
-    DWORD bytesWritten = 0;
-    if( !WriteFile(this->handles.child_stdin, val, size, &bytesWritten, nullptr) || bytesWritten != size )
-        BUG(m_parent_span, "Error writing to child, " << GetLastError());
-#else
-    if( write(this->handles.child_stdin, val, size) != static_cast<ssize_t>(size) )
-        BUG(m_parent_span, "Error writing to child, " << strerror(errno));
-#endif
+    const auto* p = reinterpret_cast<const uint8_t*>(val);
+    m_child->send_buf.insert(m_child->send_buf.end(), p, p + size);
 }
 void ProcMacroInv::send_v128u(uint64_t val)
 {
@@ -1473,25 +1554,9 @@ uint8_t ProcMacroInv::recv_u8()
 }
 void ProcMacroInv::recv_bytes_raw(void* out_void, size_t len)
 {
-    uint8_t* val = reinterpret_cast<uint8_t*>(out_void);
-    size_t  ofs = 0, rem = len;
-    while( rem > 0 )
-    {
-#ifdef _WIN32
-        DWORD n;
-        ReadFile(this->handles.child_stdout, &val[ofs], rem, &n, nullptr);
-#else
-        auto n = read(this->handles.child_stdout, &val[ofs], rem);
-#endif
-        if( n == 0 ) {
-            BUG(this->m_parent_span, "Unexpected EOF while reading from child process");
-        }
-        if( n < 0 ) {
-            BUG(this->m_parent_span, "Error while reading from child process");
-        }
-        assert(static_cast<size_t>(n) <= rem);
-        ofs += n;
-        rem -= n;
+    m_child->flush(m_parent_span);
+    if( !m_child->recv(out_void, len) ) {
+        BUG(this->m_parent_span, "Unexpected EOF while reading from child process");
     }
 
     if( m_dump_file_res.is_open() )
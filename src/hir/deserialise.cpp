@@ -44,6 +44,10 @@ namespace {
         HirDeserialiser(::HIR::serialise::Reader& in):
             m_in(in)
         {}
+        HirDeserialiser(::HIR::serialise::Reader& in, RcString crate_name):
+            m_crate_name(::std::move(crate_name)),
+            m_in(in)
+        {}
 
         RcString read_istring() { return m_in.read_istring(); }
         ::std::string read_string() { return m_in.read_string(); }
@@ -507,12 +511,13 @@ namespace {
             auto _ = m_in.open_object("HIR::ExprPtr");
             if( m_in.read_bool() )
             {
-                rv.m_mir = deserialise_mir();
+                rv.m_mir = deserialise_mir_deferred();
             }
             rv.m_erased_types = deserialise_vec< ::HIR::TypeRef>();
             return rv;
         }
-        ::MIR::FunctionPointer deserialise_mir();
+        ::MIR::FunctionPointer deserialise_mir_deferred();
+        ::MIR::Function deserialise_mir();
         ::MIR::BasicBlock deserialise_mir_basicblock();
         ::MIR::Statement deserialise_mir_statement();
         AsmCommon::Options deserialise_asm_options();
@@ -782,6 +787,7 @@ namespace {
             ::HIR::Function::Markings rv;
             rv.rustc_legacy_const_generics = deserialise_vec<unsigned>();
             rv.track_caller = m_in.read_bool();
+            rv.is_cold = m_in.read_bool();
             return rv;
         }
         ::std::vector< ::std::pair< ::HIR::Pattern, ::HIR::TypeRef> >   deserialise_fcnargs()
@@ -952,6 +958,7 @@ namespace {
     template<> DEF_D( ::HIR::TypeRef, return d.deserialise_type(); )
     template<> DEF_D( ::HIR::SimplePath, return d.deserialise_simplepath(); )
     template<> DEF_D( ::HIR::GenericPath, return d.deserialise_genericpath(); )
+    template<> DEF_D( ::HIR::Path, return d.deserialise_path(); )
     template<> DEF_D( ::HIR::TraitPath, return d.deserialise_traitpath(); )
 
     template<> DEF_D( ::HIR::TypeParamDef, return d.deserialise_typaramdef(); )
@@ -1005,7 +1012,8 @@ namespace {
     DEF_D( ::HIR::Crate::ImplGroup<std::unique_ptr<T>>,
         ::HIR::Crate::ImplGroup<std::unique_ptr<T>>  rv;
         rv.named = d.deserialise_pathmap< ::std::vector<::std::unique_ptr<T> > >();
-        rv.non_named = d.deserialise_vec< ::std::unique_ptr<T> >();
+        for(auto& i : d.deserialise_vec< ::std::unique_ptr<T> >())
+            rv.get_list_for_type_mut(i->m_type).push_back(mv$(i));
         rv.generic = d.deserialise_vec< ::std::unique_ptr<T> >();
         return rv;
         )
@@ -1400,7 +1408,30 @@ namespace {
         return rv;
     }
 
-    ::MIR::FunctionPointer HirDeserialiser::deserialise_mir()
+    // Decodes a MIR blob the first time the function's MIR is accessed
+    // - Most MIR in a dependency (e.g. all of libcore's generics) is never used by a given crate
+    class DeferredMirLoader:
+        public ::MIR::FunctionPointer::Loader
+    {
+        ::HIR::serialise::Reader    m_in;
+        RcString    m_crate_name;
+    public:
+        DeferredMirLoader(const ::HIR::serialise::Reader& parent, ::std::vector<uint8_t> blob, RcString crate_name):
+            m_in(parent, ::std::move(blob)),
+            m_crate_name(::std::move(crate_name))
+        {
+        }
+        ::MIR::Function* load() override
+        {
+            HirDeserialiser d { m_in, m_crate_name };
+            return new ::MIR::Function( d.deserialise_mir() );
+        }
+    };
+    ::MIR::FunctionPointer HirDeserialiser::deserialise_mir_deferred()
+    {
+        return ::MIR::FunctionPointer::new_deferred( new DeferredMirLoader(m_in, m_in.read_blob(), m_crate_name) );
+    }
+    ::MIR::Function HirDeserialiser::deserialise_mir()
     {
         TRACE_FUNCTION;
 
@@ -1411,7 +1442,7 @@ namespace {
         rv.drop_flags = deserialise_vec<bool>();
         rv.blocks = deserialise_vec< ::MIR::BasicBlock>( );
 
-        return ::MIR::FunctionPointer( new ::MIR::Function(mv$(rv)) );
+        return rv;
     }
     ::MIR::BasicBlock HirDeserialiser::deserialise_mir_basicblock()
     {
@@ -1656,6 +1687,7 @@ namespace {
         //rv.m_exported_macros = deserialise_istrumap< ::MacroRulesPtr>();
         //rv.m_proc_macro_reexports = deserialise_istrumap< ::HIR::Crate::MacroImport>();
         rv.m_lang_items = deserialise_strumap< ::HIR::SimplePath>();
+        rv.m_exported_monomorphs = deserialise_set< ::HIR::Path>();
 
         {
             size_t n = m_in.read_count();
@@ -1583,6 +1583,8 @@ namespace {
     {
         markings.track_caller = true;
     }
+    // #[cold] - Propagated to the backend as a branch hint
+    markings.is_cold = f.m_markings.is_cold;
 
     ::HIR::Linkage  linkage;
     linkage.section = f.m_markings.link_section;
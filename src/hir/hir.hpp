@@ -14,6 +14,7 @@
 #include <cassert>
 #include <unordered_map>
 #include <vector>
+#include <set>
 #include <memory>
 
 #include <tagged_union.hpp>
@@ -29,6 +30,7 @@
 #include <hir/crate_ptr.hpp>
 #include <hir/encoded_literal.hpp>
 #include <hir/inherent_cache.hpp>
+#include <hir/trait_impl_cache.hpp>
 
 #define ABI_RUST    "Rust"
 #define CRATE_BUILTINS  "#builtins" // used for macro re-exports of builtins
@@ -203,6 +205,8 @@ public:
     struct Markings {
         std::vector<unsigned> rustc_legacy_const_generics;
         bool track_caller = false;
+        /// `#[cold]` - Calls are unlikely, paths leading to them are laid out as such
+        bool is_cold = false;
     } m_markings;
 
     Function()
@@ -625,36 +629,48 @@ public:
     {
         typedef ::std::vector<T> list_t;
         ::std::map<::HIR::SimplePath, list_t>   named;
-        list_t  non_named; // TODO: use a map of HIR::TypeRef::Data::Tag
+        /// Impls on types without a sort path (primitives, tuples, borrows, ...), keyed on the outer type constructor
+        ::std::map<::HIR::TypeHead, list_t> non_named;
         list_t  generic;
 
-        const list_t* get_list_for_type(const ::HIR::TypeRef& ty) const {
-            static list_t empty;
+        /// Call `cb` with each (non-generic) list that could contain impls for `ty`, stopping when it returns true
+        template<typename Cb>
+        bool iterate_lists_for_type(const ::HIR::TypeRef& ty, Cb cb) const {
+            ::HIR::TypeHead head;
             if( const auto* p = ty.get_sort_path() ) {
                 auto it = named.find(*p);
                 if( it != named.end() )
-                    return &it->second;
-                else
-                    return nullptr;
+                    return cb(it->second);
+            }
+            else if( ::HIR::TypeHead::get(ty, head) ) {
+                auto it = non_named.find(head);
+                if( it != non_named.end() )
+                    return cb(it->second);
             }
             else {
-                // TODO: Sort these by type tag, use the `Primitive` group if `ty` is Infer
-                return &non_named;
+                // Unknown head (e.g. an ivar), could be any of the unnamed types
+                for(const auto& e : non_named)
+                    if( cb(e.second) )
+                        return true;
             }
+            return false;
         }
         list_t& get_list_for_type_mut(const ::HIR::TypeRef& ty) {
+            ::HIR::TypeHead head;
             if( const auto* p = ty.get_sort_path() ) {
                 return named[*p];
             }
+            else if( ::HIR::TypeHead::get(ty, head) ) {
+                return non_named[head];
+            }
             else {
-                // TODO: Ivars match with core types
-                return non_named;
+                return generic;
             }
         }
     };
     /// Impl blocks on just a type, split into three groups
     // - Named type (sorted on the path)
-    // - Primitive types
+    // - Other concrete types (sorted on the outer type constructor)
     // - Unsorted (generics, and everything before outer type resolution)
     ImplGroup<::std::unique_ptr<::HIR::TypeImpl>>  m_type_impls;
 
@@ -670,12 +686,19 @@ public:
     ::std::map< ::HIR::SimplePath, ImplGroup<const ::HIR::TraitImpl*> > m_all_trait_impls;
     ::std::map< ::HIR::SimplePath, ImplGroup<const ::HIR::MarkerImpl*> > m_all_marker_impls;
 
+    /// CACHE: Results of `find_trait_impls` on fully-known types (cleared when impls are added to the above)
+    mutable TraitImplCache  m_trait_impl_cache;
+
     /// List of legacy-exported macros
     std::vector<RcString> m_exported_macro_names;
 
     /// Language items avaliable through this crate (includes ones from loaded externs)
     ::std::unordered_map< ::std::string, ::HIR::SimplePath> m_lang_items;
 
+    /// Monomorphised generic functions that this crate's codegen emits with external linkage
+    /// - Downstream crates link to these instead of generating their own copy (see `-Z share-generics`)
+    ::std::set< ::HIR::Path>    m_exported_monomorphs;
+
     /// Referenced crates (in load order) - Used to ensure final linking order is sane
     // NOT SERIALISED
     ::std::vector<RcString> m_ext_crates_ordered;
@@ -1062,11 +1062,8 @@ namespace
         if( it != crate.m_trait_impls.end() )
         {
             // 1. Find named impls (associated with named types)
-            if( const auto* impl_list = it->second.get_list_for_type(type) )
-            {
-                if( find_impls_list(*impl_list, type, ty_res, callback) )
-                    return true;
-            }
+            if( it->second.iterate_lists_for_type(type, [&](const auto& impl_list){ return find_impls_list(impl_list, type, ty_res, callback); }) )
+                return true;
             // - If the type is an ivar, search all types
             if( type.data().is_Infer() && !type.data().as_Infer().is_lit() )
             {
@@ -1144,30 +1141,49 @@ bool ::HIR::Crate::find_trait_impls(const ::HIR::SimplePath& trait, const ::HIR:
     if( this->m_all_trait_impls.size() > 0 )
     {
         auto it = this->m_all_trait_impls.find( trait );
-        if( it != this->m_all_trait_impls.end() )
+        if( it == this->m_all_trait_impls.end() )
+            return false;
+
+        // Types without ivars always match the same impls, so the candidate list can be memoised
+        // - Only types that can be interned (no ivars, and comparable structurally) are cached
+        // - Lookup uses the structural hash, so the type is only copied (interned) when an entry is added
+        if( type.can_intern() )
         {
-            // 1. Find named impls (associated with named types)
-            if( const auto* impl_list = it->second.get_list_for_type(type) )
+            const auto* impls = m_trait_impl_cache.get(trait, type);
+            if( !impls )
             {
-                if( find_impls_list(*impl_list, type, ty_res, callback) )
-                    return true;
+                TraitImplCache::list_t  list;
+                ::std::function<bool(const ::HIR::TraitImpl&)> collect = [&](const ::HIR::TraitImpl& impl){ list.push_back(&impl); return false; };
+                it->second.iterate_lists_for_type(type, [&](const auto& impl_list){ return find_impls_list(impl_list, type, ty_res, collect); });
+                find_impls_list(it->second.generic, type, ty_res, collect);
+                impls = &m_trait_impl_cache.insert(trait, ::HIR::TypeRef::new_interned(type), mv$(list));
             }
-            // - If the type is an ivar, search all types
-            if( type.data().is_Infer() && !type.data().as_Infer().is_lit() )
+            for(const auto* impl : *impls)
             {
-                DEBUG("Search all lists");
-                for(const auto& list : it->second.named)
-                {
-                    if( find_impls_list(list.second, type, ty_res, callback) )
-                        return true;
-                }
+                if( callback(*impl) )
+                    return true;
             }
+            return false;
+        }
 
-            // 2. Search fully generic list.
-            if( find_impls_list(it->second.generic, type, ty_res, callback) )
-                return true;
+        // 1. Find named impls (associated with named types)
+        if( it->second.iterate_lists_for_type(type, [&](const auto& impl_list){ return find_impls_list(impl_list, type, ty_res, callback); }) )
+            return true;
+        // - If the type is an ivar, search all types
+        if( type.data().is_Infer() && !type.data().as_Infer().is_lit() )
+        {
+            DEBUG("Search all lists");
+            for(const auto& list : it->second.named)
+            {
+                if( find_impls_list(list.second, type, ty_res, callback) )
+                    return true;
+            }
         }
 
+        // 2. Search fully generic list.
+        if( find_impls_list(it->second.generic, type, ty_res, callback) )
+            return true;
+
         return false;
     }
 
@@ -1196,11 +1212,8 @@ namespace
         if( it != crate.m_marker_impls.end() )
         {
             // 1. Find named impls (associated with named types)
-            if( const auto* impl_list = it->second.get_list_for_type(type) )
-            {
-                if( find_impls_list(*impl_list, type, ty_res, callback) )
-                    return true;
-            }
+            if( it->second.iterate_lists_for_type(type, [&](const auto& impl_list){ return find_impls_list(impl_list, type, ty_res, callback); }) )
+                return true;
 
             // 2. Search fully generic list.
             if( find_impls_list(it->second.generic, type, ty_res, callback) )
@@ -1217,11 +1230,8 @@ bool ::HIR::Crate::find_auto_trait_impls(const ::HIR::SimplePath& trait, const :
         if( it != this->m_all_marker_impls.end() )
         {
             // 1. Find named impls (associated with named types)
-            if( const auto* impl_list = it->second.get_list_for_type(type) )
-            {
-                if( find_impls_list(*impl_list, type, ty_res, callback) )
-                    return true;
-            }
+            if( it->second.iterate_lists_for_type(type, [&](const auto& impl_list){ return find_impls_list(impl_list, type, ty_res, callback); }) )
+                return true;
 
             // 2. Search fully generic list.
             if( find_impls_list(it->second.generic, type, ty_res, callback) )
@@ -1249,11 +1259,8 @@ namespace
     bool find_type_impls_int(const ::HIR::Crate& crate, const ::HIR::TypeRef& type, ::HIR::t_cb_resolve_type ty_res, ::std::function<bool(const ::HIR::TypeImpl&)> callback)
     {
         // 1. Find named impls (associated with named types)
-        if( const auto* impl_list = crate.m_type_impls.get_list_for_type(type) )
-        {
-            if( find_impls_list(*impl_list, type, ty_res, callback) )
-                return true;
-        }
+        if( crate.m_type_impls.iterate_lists_for_type(type, [&](const auto& impl_list){ return find_impls_list(impl_list, type, ty_res, callback); }) )
+            return true;
 
         // 2. Search fully generic list?
         if( find_impls_list(crate.m_type_impls.generic, type, ty_res, callback) )
@@ -1266,11 +1273,8 @@ bool ::HIR::Crate::find_type_impls(const ::HIR::TypeRef& type, t_cb_resolve_type
 {
     if( m_all_trait_impls.size() > 0 ) {
         // 1. Find named impls (associated with named types)
-        if( const auto* impl_list = this->m_all_type_impls.get_list_for_type(type) )
-        {
-            if( find_impls_list(*impl_list, type, ty_res, callback) )
-                return true;
-        }
+        if( this->m_all_type_impls.iterate_lists_for_type(type, [&](const auto& impl_list){ return find_impls_list(impl_list, type, ty_res, callback); }) )
+            return true;
 
         // 2. Search fully generic list?
         if( find_impls_list(this->m_all_type_impls.generic, type, ty_res, callback) )
@@ -1298,15 +1302,22 @@ bool ::HIR::Crate::find_type_impls(const ::HIR::TypeRef& type, t_cb_resolve_type
 
 const ::MIR::Function* HIR::Crate::get_or_gen_mir(const ::HIR::ItemPath& ip, const ::HIR::ExprPtr& ep, const ::HIR::Function::args_t& args, const ::HIR::TypeRef& ret_ty) const
 {
-    if( !ep )
+    // Fast path: `m_mir` is atomic, and is only set once the MIR is complete (as the last step below), so it can
+    // be checked without the lock.
+    // NOTE: Nothing else (e.g. the HIR tree) can be read before taking the lock, as another thread may be running
+    // the passes below on this body.
+    if( ep.m_mir )
     {
-        // No HIR, so has to just have MIR - from a extern crate most likely
-        ASSERT_BUG(Span(), ep.m_mir, "No HIR (!ep) and no MIR (!ep.m_mir) for " << ip);
         return &*ep.m_mir;
     }
     else
     {
-        if( !ep.m_mir )
+        ::std::lock_guard<::std::recursive_mutex>   _lh(ConvertHIR_ConstantEvaluate_Lock());
+        // Another thread may have generated it while this one waited for the lock
+        if( ep.m_mir )
+            return &*ep.m_mir;
+        // No HIR, so has to just have MIR - from a extern crate most likely
+        ASSERT_BUG(Span(), ep, "No HIR (!ep) and no MIR (!ep.m_mir) for " << ip);
         {
             TRACE_FUNCTION_F(ip);
             ASSERT_BUG(Span(), ep.m_state, "No ExprState for " << ip);
@@ -1339,6 +1350,7 @@ const ::MIR::Function* HIR::Crate::get_or_gen_mir(const ::HIR::ItemPath& ip, con
                 ms.m_item_generics = ep.m_state->m_item_generics;
                 ms.m_traits = ep.m_state->m_traits;
                 ms.m_mod_paths.push_back(ep.m_state->m_mod_path);
+                ms.m_item_path = &ip;
                 Typecheck_Code(ms, const_cast<::HIR::Function::args_t&>(args), ret_ty, ep_mut);
                 //Debug_SetStagePre("Expand HIR Annotate");
                 HIR_Expand_AnnotateUsage_Expr(*this, ep_mut);
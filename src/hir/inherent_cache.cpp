@@ -13,17 +13,18 @@
 void HIR::InherentCache::Lowest::insert(const Span& sp, const HIR::TypeImpl& impl)
 {
     const auto& type = impl.m_type;
+    HIR::TypeHead   head;
     if(const auto* path = type.get_sort_path())
     {
         this->named[*path].push_back(&impl);
     }
-    else if( type.data().is_Path() || type.data().is_Generic() )
+    else if( HIR::TypeHead::get(type, head) )
     {
-        this->generic.push_back(&impl);
+        this->non_named[head].push_back(&impl);
     }
     else
     {
-        this->non_named.push_back(&impl);
+        this->generic.push_back(&impl);
     }
 }
 void HIR::InherentCache::Lowest::iterate(const HIR::TypeRef& type, InherentCache::inner_callback_t& cb) const
@@ -37,6 +38,7 @@ void HIR::InherentCache::Lowest::iterate(const HIR::TypeRef& type, InherentCache
 
     visit(this->generic);
 
+    HIR::TypeHead   head;
     if(const auto* path = type.get_sort_path())
     {
         auto it = this->named.find(*path);
@@ -45,13 +47,25 @@ void HIR::InherentCache::Lowest::iterate(const HIR::TypeRef& type, InherentCache
             visit(it->second);
         }
     }
+    else if( HIR::TypeHead::get(type, head) )
+    {
+        auto it = this->non_named.find(head);
+        if(it != this->non_named.end())
+        {
+            visit(it->second);
+        }
+    }
     else if( type.data().is_Path() || type.data().is_Generic() )
     {
         // Already handled by the unconditional generic
     }
     else
     {
-        visit(this->non_named);
+        // Unknown type (e.g. an ivar), could match any of the unnamed impls
+        for(const auto& e : this->non_named)
+        {
+            visit(e.second);
+        }
     }
 }
 
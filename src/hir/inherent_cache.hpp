@@ -26,7 +26,7 @@ private:
 		// Same as HIR::Crate::ImplGroup
 		typedef ::std::vector<const HIR::TypeImpl*>	list_t;
 		::std::map<::HIR::SimplePath, list_t>   named;
-		list_t  non_named; // TODO: use a map of HIR::TypeRef::Data::Tag
+		::std::map<::HIR::TypeHead, list_t>	non_named;
 		list_t  generic;
 
 		void insert(const Span& sp, const HIR::TypeImpl& impl);
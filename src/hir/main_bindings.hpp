@@ -18,7 +18,8 @@ namespace AST {
 
 extern void HIR_Dump(::std::ostream& sink, const ::HIR::Crate& crate);
 extern ::HIR::CratePtr  LowerHIR_FromAST(::AST::Crate crate);
-extern void HIR_Serialise(const ::std::string& filename, const ::HIR::Crate& crate);
+/// Write a crate's metadata, either zlib-compressed (`compress`) or in the raw format that the loader can map directly
+extern void HIR_Serialise(const ::std::string& filename, const ::HIR::Crate& crate, bool compress=true);
 
 extern ::HIR::CratePtr HIR_Deserialise(const ::std::string& filename);
 extern RcString HIR_Deserialise_JustName(const ::std::string& filename);
@@ -287,6 +287,7 @@
             serialise(e.source_trait);
             serialise_vec(e.traits);
         }
+        void serialise(const ::HIR::Path& path) { serialise_path(path); }
         void serialise_path(const ::HIR::Path& path)
         {
             TRACE_FUNCTION_F("path="<<path);
@@ -367,7 +368,17 @@
         void serialise(const ::HIR::Crate::ImplGroup<T>& ig)
         {
             serialise_pathmap(ig.named);
-            serialise_vec(ig.non_named);
+            // Unnamed impls are stored as a flat list (the index is rebuilt on load)
+            {
+                auto _ = m_out.open_object(typeid(typename ::HIR::Crate::ImplGroup<T>::list_t).name());
+                size_t n = 0;
+                for(const auto& e : ig.non_named)
+                    n += e.second.size();
+                m_out.write_count(n);
+                for(const auto& e : ig.non_named)
+                    for(const auto& i : e.second)
+                        serialise(i);
+            }
             serialise_vec(ig.generic);
         }
 
@@ -394,6 +405,7 @@
                 }
                 serialise_strmap(lang_items_filtered);
             }
+            serialise(crate.m_exported_monomorphs);
 
             m_out.write_count(crate.m_ext_crates.size());
             for(const auto& ext : crate.m_ext_crates)
@@ -677,7 +689,13 @@
             save_mir &= static_cast<bool>(exp.m_mir);
             m_out.write_bool( save_mir );
             if( save_mir ) {
+                // Stored as a self-contained blob (with its own type cache), so loading can be deferred until it's used
+                auto saved_types = ::std::move(m_types);
+                m_types.clear();
+                m_out.start_blob();
                 serialise(*exp.m_mir);
+                m_out.end_blob();
+                m_types = ::std::move(saved_types);
             }
             serialise_vec( exp.m_erased_types );
         }
@@ -1131,6 +1149,7 @@
             auto _ = m_out.open_object("HIR::Function::Markings");
             serialise_vec(m.rustc_legacy_const_generics);
             m_out.write_bool(m.track_caller);
+            m_out.write_bool(m.is_cold);
         }
         void serialise(const ::HIR::Constant& item)
         {
@@ -1336,13 +1355,13 @@
     };
 //}
 
-void HIR_Serialise(const ::std::string& filename, const ::HIR::Crate& crate)
+void HIR_Serialise(const ::std::string& filename, const ::HIR::Crate& crate, bool compress)
 {
     ::HIR::serialise::Writer    out;
     HirSerialiser  s { out };
     s.serialise_crate(crate);
     s.clear();
-    out.open(filename);
+    out.open(filename, compress);
     s.serialise_crate(crate);
 }
 
@@ -13,6 +13,19 @@
 #include <common.hpp>
 #include <algorithm>
 #include <iomanip>
+#if _WIN32
+#else
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
+namespace {
+    // Header for uncompressed files (a zlib stream can never start with a zero byte)
+    const char RAW_MAGIC[] = "\0MRHIR\x01";
+    const size_t RAW_MAGIC_LEN = sizeof(RAW_MAGIC) - 1;
+}
 
 namespace HIR {
 namespace serialise {
@@ -20,13 +33,14 @@ namespace serialise {
 class WriterInner
 {
     ::std::ofstream m_backing;
+    bool    m_compress;
     z_stream    m_zstream;
     ::std::vector<unsigned char> m_buffer;
 
     unsigned int    m_byte_out_count = 0;
     unsigned int    m_byte_in_count = 0;
 public:
-    WriterInner(const ::std::string& filename);
+    WriterInner(const ::std::string& filename, bool compress);
     ~WriterInner();
     void write(const void* buf, size_t len);
 };
@@ -39,7 +53,7 @@ Writer::~Writer()
 {
     delete m_inner, m_inner = nullptr;
 }
-void Writer::open(const ::std::string& filename)
+void Writer::open(const ::std::string& filename, bool compress)
 {
     // 1. Sort strings by frequency
     ::std::vector<::std::pair<RcString, unsigned>> sorted;
@@ -51,7 +65,7 @@ void Writer::open(const ::std::string& filename)
 
     m_objname_cache.clear();
 
-    m_inner = new WriterInner(filename);
+    m_inner = new WriterInner(filename, compress);
     // 3. Reset m_istring_cache to use the same value
     this->write_count(sorted.size());
     for(size_t i = 0; i < sorted.size(); i ++)
@@ -68,7 +82,11 @@ void Writer::open(const ::std::string& filename)
 }
 void Writer::write(const void* buf, size_t len)
 {
-    if( m_inner ) {
+    if( m_inner && m_in_blob ) {
+        auto p = reinterpret_cast<const uint8_t*>(buf);
+        m_blob_data.insert(m_blob_data.end(), p, p + len);
+    }
+    else if( m_inner ) {
         DEBUG("write(" << FMT_CB(ss, for(size_t i = 0; i < len; i ++) ss << std::setw(2) << std::setfill('0') << std::hex << unsigned( ((const uint8_t*)buf)[i] )) << ")");
         m_inner->write(buf, len);
     }
@@ -76,6 +94,22 @@ void Writer::write(const void* buf, size_t len)
         // No-op, pre caching
     }
 }
+void Writer::start_blob()
+{
+    assert(!m_in_blob && "Nested blobs are not supported");
+    m_in_blob = true;
+    m_blob_data.clear();
+    ::std::swap(m_objname_cache, m_blob_saved_objnames);
+    m_objname_cache.clear();
+}
+void Writer::end_blob()
+{
+    assert(m_in_blob);
+    m_in_blob = false;
+    ::std::swap(m_objname_cache, m_blob_saved_objnames);
+    this->raw_write_bytes(m_blob_data.size(), m_blob_data.data());
+    m_blob_data.clear();
+}
 void Writer::write_string(const RcString& v)
 {
     if( m_inner ) {
@@ -89,12 +123,18 @@ void Writer::write_string(const RcString& v)
 }
 
 
-WriterInner::WriterInner(const ::std::string& filename):
+WriterInner::WriterInner(const ::std::string& filename, bool compress):
     m_backing( filename, ::std::ios_base::out | ::std::ios_base::binary),
+    m_compress(compress),
     m_zstream(),
     m_buffer( 16*1024 )
     //m_buffer( 4*1024 )
 {
+    if( !m_compress )
+    {
+        m_backing.write(RAW_MAGIC, RAW_MAGIC_LEN);
+        return ;
+    }
     m_zstream.zalloc = Z_NULL;
     m_zstream.zfree = Z_NULL;
     m_zstream.opaque = Z_NULL;
@@ -109,6 +149,8 @@ WriterInner::WriterInner(const ::std::string& filename):
 }
 WriterInner::~WriterInner()
 {
+    if( !m_compress )
+        return ;
     assert( m_zstream.avail_in == 0 );
 
     // Complete the compression
@@ -135,6 +177,12 @@ WriterInner::~WriterInner()
 
 void WriterInner::write(const void* buf, size_t len)
 {
+    if( !m_compress )
+    {
+        m_backing.write( reinterpret_cast<const char*>(buf), len );
+        m_byte_out_count += len;
+        return ;
+    }
     m_zstream.avail_in = len;
     m_zstream.next_in = reinterpret_cast<unsigned char*>( const_cast<void*>(buf) );
 
@@ -191,33 +239,55 @@ class ReaderInner
     z_stream    m_zstream;
     ::std::vector<unsigned char> m_buffer;
 
+    // Uncompressed files are mapped (or loaded whole) instead of streamed through zlib
+    bool    m_is_raw = false;
+    void*   m_map_base = nullptr;
+    size_t  m_map_size = 0;
+
     unsigned int    m_byte_out_count = 0;
     unsigned int    m_byte_in_count = 0;
 public:
     ReaderInner(const ::std::string& filename);
     ~ReaderInner();
     size_t read(void* buf, size_t len);
+
+    bool is_raw() const { return m_is_raw; }
+    /// Contents of an uncompressed file (after the header)
+    const uint8_t* raw_data() const;
+    size_t raw_size() const;
+private:
+    void map_file(const ::std::string& filename);
 };
 
 
 ReadBuffer::ReadBuffer(size_t cap):
+    m_data(nullptr),
+    m_size(0),
     m_ofs(0)
 {
     m_backing.reserve(cap);
+    m_data = m_backing.data();
+}
+ReadBuffer::ReadBuffer(::std::vector<uint8_t> data):
+    m_backing(::std::move(data)),
+    m_data(m_backing.data()),
+    m_size(m_backing.size()),
+    m_ofs(0)
+{
 }
 size_t ReadBuffer::read(void* dst, size_t len)
 {
-    size_t rem = m_backing.size() - m_ofs;
+    size_t rem = m_size - m_ofs;
     if( rem >= len )
     {
-        memcpy(dst, m_backing.data() + m_ofs, len);
+        memcpy(dst, m_data + m_ofs, len);
         m_ofs += len;
         return len;
     }
     else
     {
-        memcpy(dst, m_backing.data() + m_ofs, rem);
-        m_ofs = m_backing.size();
+        memcpy(dst, m_data + m_ofs, rem);
+        m_ofs = m_size;
         return rem;
     }
 }
@@ -226,6 +296,16 @@ void ReadBuffer::populate(ReaderInner& is)
     m_backing.resize( m_backing.capacity(), 0 );
     auto len = is.read(m_backing.data(), m_backing.size());
     m_backing.resize( len );
+    m_data = m_backing.data();
+    m_size = m_backing.size();
+    m_ofs = 0;
+}
+void ReadBuffer::set_view(const uint8_t* data, size_t len)
+{
+    m_backing.clear();
+    m_backing.shrink_to_fit();
+    m_data = data;
+    m_size = len;
     m_ofs = 0;
 }
 
@@ -233,16 +313,55 @@ void ReadBuffer::populate(ReaderInner& is)
 Reader::Reader(const ::std::string& filename):
     m_inner( new ReaderInner(filename) ),
     m_buffer(1024),
-    m_pos(0)
+    m_pos(0),
+    m_strings(::std::make_shared<::std::vector<RcString>>())
+{
+    if( m_inner->is_raw() )
+    {
+        m_buffer.set_view( m_inner->raw_data(), m_inner->raw_size() );
+    }
+    read_string_table();
+}
+void Reader::read_string_table()
 {
     size_t n_strings = read_count();
-    m_strings.reserve(n_strings);
     DEBUG("n_strings = " << n_strings);
-    for(size_t i = 0; i < n_strings; i ++)
+    if( m_inner->is_raw() )
     {
-        auto s = read_string();
-        m_strings.push_back( RcString::new_interned(s) );
+        // The entire file is in memory, so intern directly from the buffer in one batch
+        ::std::vector<::std::pair<const char*,size_t>>  strings;
+        strings.reserve(n_strings);
+        for(size_t i = 0; i < n_strings; i ++)
+        {
+            size_t len = read_u8();
+            if( len >= 128 ) {
+                len = (len & 0x7F) << 16;
+                len |= read_u16();
+            }
+            if( len > m_buffer.remaining() )
+                throw ::std::runtime_error( FMT("Reader - String table entry " << i << " runs past the end of the file") );
+            strings.push_back(::std::make_pair( reinterpret_cast<const char*>(m_buffer.cur_ptr()), len ));
+            m_buffer.skip(len);
+            m_pos += len;
+        }
+        *m_strings = RcString::new_interned_bulk(strings);
     }
+    else
+    {
+        m_strings->reserve(n_strings);
+        for(size_t i = 0; i < n_strings; i ++)
+        {
+            auto s = read_string();
+            m_strings->push_back( RcString::new_interned(s) );
+        }
+    }
+}
+Reader::Reader(const Reader& parent, ::std::vector<uint8_t> blob):
+    m_inner(nullptr),
+    m_buffer(::std::move(blob)),
+    m_pos(0),
+    m_strings(parent.m_strings)
+{
 }
 Reader::~Reader()
 {
@@ -258,6 +377,10 @@ void Reader::read(void* buf, size_t len)
     }
     buf = reinterpret_cast<uint8_t*>(buf) + used;
     len -= used;
+    if( !m_inner )
+        throw ::std::runtime_error( FMT("Reader::read - Requested " << len << " bytes past the end of a blob") );
+    if( m_inner->is_raw() )
+        throw ::std::runtime_error( FMT("Reader::read - Requested " << len << " bytes past the end of the file") );
 
     if( len >= m_buffer.capacity() )
     {
@@ -283,6 +406,18 @@ ReaderInner::ReaderInner(const ::std::string& filename):
     if( !m_backing.is_open() )
         throw ::std::runtime_error("Unable to open file");
 
+    char    magic[RAW_MAGIC_LEN];
+    m_backing.read(magic, RAW_MAGIC_LEN);
+    if( m_backing.gcount() == static_cast<::std::streamsize>(RAW_MAGIC_LEN) && memcmp(magic, RAW_MAGIC, RAW_MAGIC_LEN) == 0 )
+    {
+        m_backing.close();
+        m_is_raw = true;
+        map_file(filename);
+        return ;
+    }
+    m_backing.clear();
+    m_backing.seekg(0);
+
     m_zstream.zalloc = Z_NULL;
     m_zstream.zfree = Z_NULL;
     m_zstream.opaque = Z_NULL;
@@ -295,8 +430,62 @@ ReaderInner::ReaderInner(const ::std::string& filename):
 }
 ReaderInner::~ReaderInner()
 {
+    if( m_is_raw )
+    {
+#if _WIN32
+#else
+        if( m_map_base )
+            munmap(m_map_base, m_map_size);
+#endif
+        return ;
+    }
     inflateEnd(&m_zstream);
 }
+void ReaderInner::map_file(const ::std::string& filename)
+{
+#if _WIN32
+    // TODO: Use `CreateFileMapping`, for now just load the whole file
+    ::std::ifstream is(filename, ::std::ios_base::in|::std::ios_base::binary);
+    is.seekg(0, ::std::ios_base::end);
+    m_buffer.resize( static_cast<size_t>(is.tellg()) );
+    is.seekg(0);
+    is.read( reinterpret_cast<char*>(m_buffer.data()), m_buffer.size() );
+    if( is.gcount() != static_cast<::std::streamsize>(m_buffer.size()) )
+        throw ::std::runtime_error("Unable to read file");
+    m_map_size = m_buffer.size();
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if( fd < 0 )
+        throw ::std::runtime_error("Unable to open file");
+    struct stat st;
+    if( fstat(fd, &st) != 0 ) {
+        ::close(fd);
+        throw ::std::runtime_error("Unable to stat file");
+    }
+    m_map_size = static_cast<size_t>(st.st_size);
+    m_map_base = mmap(nullptr, m_map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if( m_map_base == MAP_FAILED ) {
+        m_map_base = nullptr;
+        throw ::std::runtime_error("Unable to map file");
+    }
+#endif
+    assert(m_map_size >= RAW_MAGIC_LEN);
+}
+const uint8_t* ReaderInner::raw_data() const
+{
+    assert(m_is_raw);
+#if _WIN32
+    return m_buffer.data() + RAW_MAGIC_LEN;
+#else
+    return reinterpret_cast<const uint8_t*>(m_map_base) + RAW_MAGIC_LEN;
+#endif
+}
+size_t ReaderInner::raw_size() const
+{
+    assert(m_is_raw);
+    return m_map_size - RAW_MAGIC_LEN;
+}
 size_t ReaderInner::read(void* buf, size_t len)
 {
     m_zstream.avail_out = len;
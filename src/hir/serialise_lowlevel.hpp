@@ -22,6 +22,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <memory>
 #include <stddef.h>
 #include <assert.h>
 #include <rc_string.hpp>
@@ -37,13 +38,20 @@ class Writer
     WriterInner*    m_inner;
     ::std::map<RcString, unsigned>  m_istring_cache;
     ::std::map<const char*, unsigned>  m_objname_cache;
+
+    // Active blob (see `start_blob`)
+    bool    m_in_blob = false;
+    ::std::vector<uint8_t>  m_blob_data;
+    ::std::map<const char*, unsigned>  m_blob_saved_objnames;
 public:
     Writer();
     Writer(const Writer&) = delete;
     Writer(Writer&&) = delete;
     ~Writer();
 
-    void open(const ::std::string& filename);
+    /// Open the output file and emit the string table
+    /// - `compress` selects the zlib container, otherwise the data is stored raw so the reader can map it directly
+    void open(const ::std::string& filename, bool compress=true);
     void write(const void* data, size_t count);
 
     void write_u8(uint8_t v) {
@@ -220,19 +228,36 @@ public:
     void close_object() {
         write_u8(0xFF);
     }
+
+    /// Start a length-prefixed blob, which the reader can skip over and decode later (see `Reader::read_blob`)
+    /// - The blob has its own object name table, so it can be decoded independently of the surrounding data
+    void start_blob();
+    void end_blob();
 };
 
 
 class ReadBuffer
 {
     ::std::vector<uint8_t>  m_backing;
-    unsigned int    m_ofs;
+    // Data being read - either `m_backing`, or an external view (see `set_view`)
+    const uint8_t*  m_data;
+    size_t  m_size;
+    size_t  m_ofs;
 public:
     ReadBuffer(size_t size);
+    ReadBuffer(::std::vector<uint8_t> data);
+    ReadBuffer(const ReadBuffer&) = delete;
 
     size_t capacity() const { return m_backing.capacity(); }
     size_t read(void* dst, size_t len);
     void populate(ReaderInner& is);
+
+    /// Read directly from memory owned by someone else (e.g. a mapped file)
+    void set_view(const uint8_t* data, size_t len);
+    /// Pointer to the unread data, and the number of bytes available there
+    const uint8_t* cur_ptr() const { return m_data + m_ofs; }
+    size_t remaining() const { return m_size - m_ofs; }
+    void skip(size_t len) { assert(len <= remaining()); m_ofs += len; }
 };
 
 class Reader
@@ -240,14 +265,20 @@ class Reader
     ReaderInner*    m_inner;
     ReadBuffer  m_buffer;
     size_t  m_pos;
-    ::std::vector<RcString> m_strings;
+    // Shared with readers created for blobs
+    ::std::shared_ptr<::std::vector<RcString>>  m_strings;
 
     ::std::vector<std::string>  m_objname_cache;
 public:
     Reader(const ::std::string& path);
+    /// Reader for a blob returned by `read_blob` (sharing the string table of the original reader)
+    Reader(const Reader& parent, ::std::vector<uint8_t> blob);
     Reader(const Writer&) = delete;
     Reader(Writer&&) = delete;
     ~Reader();
+private:
+    void read_string_table();
+public:
 
     size_t get_pos() const { return m_pos; }
     void read(void* dst, size_t count);
@@ -362,7 +393,7 @@ public:
     }
     RcString read_istring() {
         size_t idx = read_count();
-        return m_strings.at(idx);
+        return m_strings->at(idx);
     }
     ::std::string read_string() {
         size_t len = read_u8();
@@ -423,6 +454,13 @@ public:
             abort();
         }
     }
+    /// Read the raw contents of a blob written by `Writer::start_blob`/`Writer::end_blob`
+    ::std::vector<uint8_t> read_blob() {
+        auto len = raw_read_len();
+        ::std::vector<uint8_t>  rv(len);
+        read(rv.data(), len);
+        return rv;
+    }
     std::string raw_read_bytes_stdstring() {
         auto len = raw_read_len();
         std::string rv(len, '\0');
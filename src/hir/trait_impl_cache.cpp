@@ -0,0 +1,45 @@
+/*
+ * MRustC - Rust Compiler
+ * - By John Hodge (Mutabah/thePowersGang)
+ *
+ * hir/trait_impl_cache.cpp
+ * - Memoised trait impl lookups for fully-known types
+ */
+#include "trait_impl_cache.hpp"
+
+::std::atomic<unsigned long long> HIR::TraitImplCache::s_hits;
+::std::atomic<unsigned long long> HIR::TraitImplCache::s_misses;
+
+HIR::TraitImplCache::TraitImplCache():
+    m_lock(new ::std::mutex())
+{
+}
+
+const HIR::TraitImplCache::list_t* HIR::TraitImplCache::get(const ::HIR::SimplePath& trait, const ::HIR::TypeRef& type) const
+{
+    ::std::lock_guard<::std::mutex> _lh(*m_lock);
+    auto it = m_entries.find(trait);
+    if( it != m_entries.end() )
+    {
+        auto it2 = it->second.find(type);
+        if( it2 != it->second.end() )
+        {
+            s_hits ++;
+            return &it2->second;
+        }
+    }
+    s_misses ++;
+    return nullptr;
+}
+const HIR::TraitImplCache::list_t& HIR::TraitImplCache::insert(const ::HIR::SimplePath& trait, ::HIR::TypeRef type, list_t impls)
+{
+    assert(type.is_interned());
+    ::std::lock_guard<::std::mutex> _lh(*m_lock);
+    // NOTE: If another thread got here first, its (identical) result is kept
+    return m_entries[trait].insert(::std::make_pair(mv$(type), mv$(impls))).first->second;
+}
+void HIR::TraitImplCache::clear()
+{
+    ::std::lock_guard<::std::mutex> _lh(*m_lock);
+    m_entries.clear();
+}
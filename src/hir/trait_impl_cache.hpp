@@ -0,0 +1,51 @@
+/*
+ * MRustC - Rust Compiler
+ * - By John Hodge (Mutabah/thePowersGang)
+ *
+ * hir/trait_impl_cache.hpp
+ * - Memoised trait impl lookups for fully-known types
+ */
+#pragma once
+#include "type.hpp"
+#include "path.hpp"
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace HIR {
+
+class TraitImpl;
+
+/// <summary>
+/// Cache of the impls that match a (trait, type) pair, used by `Crate::find_trait_impls`
+/// </summary>
+/// Only types without ivars are cached (keyed on the interned type), as those always produce the
+/// same candidate list. Shared by everything that searches the crate (typeck, MIR lowering, trans).
+class TraitImplCache
+{
+public:
+    typedef ::std::vector<const ::HIR::TraitImpl*>  list_t;
+private:
+    typedef ::std::unordered_map<::HIR::TypeRef, list_t, ::std::hash<::HIR::TypeRef>, ::HIR::TypeRefOrdEqual>  type_map_t;
+
+    ::std::unique_ptr<::std::mutex> m_lock;
+    ::std::map<::HIR::SimplePath, type_map_t>  m_entries;
+public:
+    static ::std::atomic<unsigned long long>    s_hits;
+    static ::std::atomic<unsigned long long>    s_misses;
+
+    TraitImplCache();
+    TraitImplCache(TraitImplCache&& x) = default;
+    TraitImplCache& operator=(TraitImplCache&& x) = default;
+
+    /// Get the cached impl list, returns nullptr if not yet populated (`type` must satisfy `can_intern`, but doesn't need to be interned)
+    const list_t* get(const ::HIR::SimplePath& trait, const ::HIR::TypeRef& type) const;
+    /// Store a completed search (returns the stored list, which remains valid until `clear`)
+    const list_t& insert(const ::HIR::SimplePath& trait, ::HIR::TypeRef type, list_t impls);
+    /// Drop all entries, must be called whenever an impl is added to the crate's index
+    void clear();
+};
+
+}
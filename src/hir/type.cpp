@@ -8,6 +8,8 @@
 #include "type.hpp"
 #include <span.hpp>
 #include "expr.hpp" // Hack for cloning array types
+#include <mutex>
+#include <unordered_set>
 
 namespace HIR {
 
@@ -254,6 +256,9 @@ bool ::HIR::TypeRef::operator==(const ::HIR::TypeRef& x) const
     
     if( !m_ptr || !x.m_ptr )
         return false;
+    // Interned types are unique, so two distinct interned instances are never equal
+    if( m_ptr->m_interned && x.m_ptr->m_interned )
+        return false;
     if( data().tag() != x.data().tag() )
         return false;
 
@@ -1019,6 +1024,280 @@ const ::HIR::TraitMarkings* HIR::TypePathBinding::get_trait_markings() const
     }
     throw "";
 }
+
+namespace {
+    size_t hash_combine(size_t h, size_t v) {
+        return h ^ (v + 0x9e3779b9 + (h << 6) + (h >> 2));
+    }
+    size_t hash_params(size_t h, const ::HIR::PathParams& pp) {
+        for(const auto& t : pp.m_types)
+            h = hash_combine(h, t.hash());
+        return h;
+    }
+    size_t hash_simplepath(size_t h, const ::HIR::SimplePath& p) {
+        h = hash_combine(h, ::std::hash<RcString>()(p.m_crate_name));
+        for(const auto& c : p.m_components)
+            h = hash_combine(h, ::std::hash<RcString>()(c));
+        return h;
+    }
+    // NOTE: Only hashes fields that both `==` and `ord` consider (e.g. not const generic values or trait object details)
+    size_t hash_path(size_t h, const ::HIR::Path& p) {
+        h = hash_combine(h, static_cast<size_t>(p.m_data.tag()));
+        TU_MATCH_HDRA( (p.m_data), {)
+        TU_ARMA(Generic, e) {
+            h = hash_params(hash_simplepath(h, e.m_path), e.m_params);
+            }
+        TU_ARMA(UfcsInherent, e) {
+            h = hash_combine(h, e.type.hash());
+            h = hash_params(hash_combine(h, ::std::hash<RcString>()(e.item)), e.params);
+            }
+        TU_ARMA(UfcsKnown, e) {
+            h = hash_simplepath(hash_combine(h, e.type.hash()), e.trait.m_path);
+            h = hash_params(hash_combine(h, ::std::hash<RcString>()(e.item)), e.params);
+            }
+        TU_ARMA(UfcsUnknown, e) {
+            h = hash_combine(h, e.type.hash());
+            h = hash_params(hash_combine(h, ::std::hash<RcString>()(e.item)), e.params);
+            }
+        }
+        return h;
+    }
+
+    struct InternedHash {
+        size_t operator()(const ::HIR::TypeRef& ty) const { return ty.hash(); }
+    };
+    ::std::mutex    s_interned_types_lock;
+    ::std::unordered_set< ::HIR::TypeRef, InternedHash >   s_interned_types;
+}
+
+size_t HIR::TypeRef::hash() const
+{
+    if( m_ptr->m_interned )
+        return m_ptr->m_hash;
+
+    size_t  h = static_cast<size_t>(data().tag());
+    TU_MATCH_HDRA( (data()), {)
+    TU_ARMA(Infer, e) {
+        h = hash_combine(h, e.index);
+        }
+    TU_ARMA(Diverge, e) {
+        }
+    TU_ARMA(Primitive, e) {
+        h = hash_combine(h, static_cast<size_t>(e));
+        }
+    TU_ARMA(Path, e) {
+        h = hash_path(h, e.path);
+        }
+    TU_ARMA(Generic, e) {
+        h = hash_combine(h, e.binding);
+        }
+    TU_ARMA(TraitObject, e) {
+        h = hash_simplepath(h, e.m_trait.m_path.m_path);
+        }
+    TU_ARMA(ErasedType, e) {
+        }
+    TU_ARMA(Array, e) {
+        h = hash_combine(h, e.inner.hash());
+        }
+    TU_ARMA(Slice, e) {
+        h = hash_combine(h, e.inner.hash());
+        }
+    TU_ARMA(Tuple, e) {
+        for(const auto& t : e)
+            h = hash_combine(h, t.hash());
+        }
+    TU_ARMA(Borrow, e) {
+        h = hash_combine(hash_combine(h, static_cast<size_t>(e.type)), e.inner.hash());
+        }
+    TU_ARMA(Pointer, e) {
+        h = hash_combine(hash_combine(h, static_cast<size_t>(e.type)), e.inner.hash());
+        }
+    TU_ARMA(Function, e) {
+        for(const auto& t : e.m_arg_types)
+            h = hash_combine(h, t.hash());
+        h = hash_combine(h, e.m_rettype.hash());
+        }
+    TU_ARMA(Closure, e) {
+        h = hash_combine(h, ::std::hash<const void*>()(e.node));
+        }
+    TU_ARMA(Generator, e) {
+        h = hash_combine(h, ::std::hash<const void*>()(e.node));
+        }
+    }
+    return h;
+}
+
+bool HIR::TypeRef::can_intern() const
+{
+    if( is_interned() )
+        return true;
+
+    auto params_can_intern = [](const ::HIR::PathParams& pp) {
+        for(const auto& t : pp.m_types)
+            if( !t.can_intern() )
+                return false;
+        return true;
+        };
+    TU_MATCH_HDRA( (data()), {)
+    TU_ARMA(Infer, e) {
+        return false;
+        }
+    TU_ARMA(Diverge, e) {
+        return true;
+        }
+    TU_ARMA(Primitive, e) {
+        return true;
+        }
+    TU_ARMA(Path, e) {
+        if( e.binding.is_Unbound() )
+            return false;
+        TU_MATCH_HDRA( (e.path.m_data), {)
+        TU_ARMA(Generic, pe) {
+            return params_can_intern(pe.m_params);
+            }
+        TU_ARMA(UfcsInherent, pe) {
+            return pe.type.can_intern() && params_can_intern(pe.params) && params_can_intern(pe.impl_params);
+            }
+        TU_ARMA(UfcsKnown, pe) {
+            return pe.type.can_intern() && params_can_intern(pe.trait.m_params) && params_can_intern(pe.params);
+            }
+        TU_ARMA(UfcsUnknown, pe) {
+            return false;
+            }
+        }
+        }
+    TU_ARMA(Generic, e) {
+        return true;
+        }
+    // Trait objects and erased types have equality rules that differ between `==` and `ord`
+    TU_ARMA(TraitObject, e) {
+        return false;
+        }
+    TU_ARMA(ErasedType, e) {
+        return false;
+        }
+    TU_ARMA(Array, e) {
+        return e.inner.can_intern();
+        }
+    TU_ARMA(Slice, e) {
+        return e.inner.can_intern();
+        }
+    TU_ARMA(Tuple, e) {
+        for(const auto& t : e)
+            if( !t.can_intern() )
+                return false;
+        return true;
+        }
+    TU_ARMA(Borrow, e) {
+        return e.inner.can_intern();
+        }
+    TU_ARMA(Pointer, e) {
+        return e.inner.can_intern();
+        }
+    TU_ARMA(Function, e) {
+        for(const auto& t : e.m_arg_types)
+            if( !t.can_intern() )
+                return false;
+        return e.m_rettype.can_intern();
+        }
+    // Closures and generators refer to expression nodes, which may be mutated
+    TU_ARMA(Closure, e) {
+        return false;
+        }
+    TU_ARMA(Generator, e) {
+        return false;
+        }
+    }
+    throw "";
+}
+::HIR::TypeRef HIR::TypeRef::new_interned(const ::HIR::TypeRef& ty)
+{
+    if( ty.is_interned() )
+        return ty.clone();
+    if( !ty.can_intern() )
+        return ty.clone();
+
+    // Take a private copy of the top level, and replace all child types with their interned versions
+    auto rv = ty.clone_shallow();
+    auto intern_child = [&](::HIR::TypeRef& child) {
+        child = new_interned(child);
+        assert(child.is_interned());
+        };
+    auto intern_params = [&](::HIR::PathParams& pp) {
+        for(auto& t : pp.m_types)
+            intern_child(t);
+        };
+    TU_MATCH_HDRA( (rv.m_ptr->m_data), {)
+    TU_ARMA(Infer, e) {
+        }
+    TU_ARMA(Diverge, e) {
+        }
+    TU_ARMA(Primitive, e) {
+        }
+    TU_ARMA(Path, e) {
+        TU_MATCH_HDRA( (e.path.m_data), {)
+        TU_ARMA(Generic, pe) {
+            intern_params(pe.m_params);
+            }
+        TU_ARMA(UfcsInherent, pe) {
+            intern_child(pe.type);
+            intern_params(pe.params);
+            intern_params(pe.impl_params);
+            }
+        TU_ARMA(UfcsKnown, pe) {
+            intern_child(pe.type);
+            intern_params(pe.trait.m_params);
+            intern_params(pe.params);
+            }
+        TU_ARMA(UfcsUnknown, pe) {
+            }
+        }
+        }
+    TU_ARMA(Generic, e) {
+        }
+    TU_ARMA(TraitObject, e) {
+        }
+    TU_ARMA(ErasedType, e) {
+        }
+    TU_ARMA(Array, e) {
+        intern_child(e.inner);
+        }
+    TU_ARMA(Slice, e) {
+        intern_child(e.inner);
+        }
+    TU_ARMA(Tuple, e) {
+        for(auto& t : e)
+            intern_child(t);
+        }
+    TU_ARMA(Borrow, e) {
+        intern_child(e.inner);
+        }
+    TU_ARMA(Pointer, e) {
+        intern_child(e.inner);
+        }
+    TU_ARMA(Function, e) {
+        for(auto& t : e.m_arg_types)
+            intern_child(t);
+        intern_child(e.m_rettype);
+        }
+    TU_ARMA(Closure, e) {
+        }
+    TU_ARMA(Generator, e) {
+        }
+    }
+
+    // Calculated outside the lock (cheap, as all children have cached hashes)
+    size_t  h = rv.hash();
+
+    ::std::lock_guard<::std::mutex> _lh(s_interned_types_lock);
+    auto it = s_interned_types.find(rv);
+    if( it != s_interned_types.end() )
+        return it->clone();
+    rv.m_ptr->m_hash = h;
+    rv.m_ptr->m_interned = true;
+    s_interned_types.insert( rv.clone() );
+    return rv;
+}
 ::HIR::Compare HIR::TypeRef::compare_with_placeholders(const Span& sp, const ::HIR::TypeRef& x, t_cb_resolve_type resolve_placeholder) const
 {
     //TRACE_FUNCTION_F(*this << " ?= " << x);
@@ -1293,3 +1572,52 @@ const ::HIR::TraitMarkings* HIR::TypePathBinding::get_trait_markings() const
     }
     throw "";
 }
+
+bool HIR::TypeHead::get(const ::HIR::TypeRef& ty, TypeHead& out)
+{
+    out.tag = static_cast<unsigned int>(ty.data().tag());
+    out.sub = 0;
+    TU_MATCH_HDRA( (ty.data()), {)
+    TU_ARMA(Infer, e) {
+        return false;
+        }
+    TU_ARMA(Generic, e) {
+        return false;
+        }
+    TU_ARMA(Path, e) {
+        // Named paths use `get_sort_path`, anything else (e.g. an unresolved associated type) could be any type
+        return false;
+        }
+    TU_ARMA(ErasedType, e) {
+        return false;
+        }
+    TU_ARMA(Diverge, e) {
+        }
+    TU_ARMA(Primitive, e) {
+        out.sub = static_cast<unsigned int>(e);
+        }
+    TU_ARMA(TraitObject, e) {
+        }
+    TU_ARMA(Array, e) {
+        }
+    TU_ARMA(Slice, e) {
+        }
+    TU_ARMA(Tuple, e) {
+        out.sub = static_cast<unsigned int>(e.size());
+        }
+    TU_ARMA(Borrow, e) {
+        out.sub = static_cast<unsigned int>(e.type);
+        }
+    TU_ARMA(Pointer, e) {
+        out.sub = static_cast<unsigned int>(e.type);
+        }
+    TU_ARMA(Function, e) {
+        out.sub = static_cast<unsigned int>(e.m_arg_types.size());
+        }
+    TU_ARMA(Closure, e) {
+        }
+    TU_ARMA(Generator, e) {
+        }
+    }
+    return true;
+}
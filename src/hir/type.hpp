@@ -9,6 +9,7 @@
 #define _HIR_TYPE_HPP_
 #pragma once
 
+#include <atomic>
 #include <tagged_union.hpp>
 #include <hir/path.hpp>
 #include <hir/expr_ptr.hpp>
@@ -211,12 +212,18 @@ public:
     // Existing TypeRef
 
 private:
-    unsigned    m_refcount;
+    ::std::atomic<unsigned> m_refcount;
+    /// Set when this is the canonical copy held by the type interner (see `TypeRef::new_interned`)
+    bool    m_interned;
+    /// Cached structural hash, only valid when `m_interned` is set
+    size_t  m_hash;
 public:
     TypeData   m_data;
 private:
     TypeInner(TypeData d):
         m_refcount(1),
+        m_interned(false),
+        m_hash(0),
         m_data(mv$(d))
     {
     }
@@ -239,8 +246,7 @@ inline TypeRef::~TypeRef()
 {
     if(m_ptr)
     {
-        m_ptr->m_refcount -= 1;
-        if(m_ptr->m_refcount == 0)
+        if(--m_ptr->m_refcount == 0)
         {
             delete m_ptr;
             m_ptr = nullptr;
@@ -248,8 +254,10 @@ inline TypeRef::~TypeRef()
     }
 }
 inline const TypeData& TypeRef::data() const { assert(m_ptr); return m_ptr->m_data; }
-inline TypeData& TypeRef::data_mut() { assert(m_ptr); return m_ptr->m_data; }
-inline TypeData& TypeRef::get_unique() { assert(m_ptr); if(m_ptr->m_refcount != 1) *this = this->clone_shallow(); return m_ptr->m_data; }
+// NOTE: Interned types are shared by every user, so mutating one must make a private copy first
+inline TypeData& TypeRef::data_mut() { assert(m_ptr); if(m_ptr->m_interned) *this = this->clone_shallow(); return m_ptr->m_data; }
+inline bool TypeRef::is_interned() const { return m_ptr && m_ptr->m_interned; }
+inline TypeData& TypeRef::get_unique() { assert(m_ptr); if(m_ptr->m_refcount != 1 || m_ptr->m_interned) *this = this->clone_shallow(); return m_ptr->m_data; }
 
 
 inline TypeRef::TypeRef(::HIR::CoreType ct):
@@ -426,7 +434,26 @@ public:
 
 extern ::std::ostream& operator<<(::std::ostream& os, const ::HIR::TypeRef& ty);
 
+/// Key equality for hashed containers that replace a `std::map` keyed on `TypeRef` (matches `ord`, not `==`)
+struct TypeRefOrdEqual
+{
+    bool operator()(const ::HIR::TypeRef& a, const ::HIR::TypeRef& b) const {
+        if( a.is_interned() && b.is_interned() )
+            return &a.data() == &b.data();
+        return a.ord(b) == OrdEqual;
+    }
+};
+
 }   // namespace HIR
 
+namespace std {
+    template<> struct hash< ::HIR::TypeRef>
+    {
+        size_t operator()(const ::HIR::TypeRef& ty) const {
+            return ty.hash();
+        }
+    };
+}
+
 #endif
 
@@ -96,6 +96,13 @@ public:
     static TypeRef new_closure(::HIR::ExprNode_Closure* node_ptr, ::std::vector< ::HIR::TypeRef> args, ::HIR::TypeRef rv);
     static TypeRef new_generator(::HIR::ExprNode_Generator* node_ptr);
 
+    /// Obtain the canonical shared instance of a fully-resolved type.
+    /// Interned instances can be compared by pointer and have a cached hash, types that can't be
+    /// interned (containing ivars, unbound paths, trait objects, ...) are returned as a plain clone.
+    static TypeRef new_interned(const TypeRef& ty);
+    /// Check if `new_interned` would return an interned instance (without allocating)
+    bool can_intern() const;
+
     // Duplicate refcount
     TypeRef clone() const;
     // Duplicate data, inner refcount
@@ -108,6 +115,9 @@ public:
     bool operator!=(const ::HIR::TypeRef& x) const { return !(*this == x); }
     bool operator<(const ::HIR::TypeRef& x) const { return ord(x) == OrdLess; }
     Ordering ord(const ::HIR::TypeRef& x) const;
+    /// Structural hash, consistent with both `==` and `ord` (cached for interned types)
+    size_t hash() const;
+    bool is_interned() const;
 
 
     //void match_generics(const Span& sp, const ::HIR::TypeRef& x_in, t_cb_resolve_type resolve_placeholder, MatchGenerics& callback) const;
@@ -121,4 +131,18 @@ public:
     const ::HIR::SimplePath* get_sort_path() const;
 };
 
+/// Outermost constructor of a type without a sort path (see `TypeRef::get_sort_path`), used to index impls
+struct TypeHead
+{
+    unsigned int    tag;    // `TypeData::Tag`
+    unsigned int    sub;    // Primitive kind, borrow/pointer kind, or tuple/function arity (zero otherwise)
+
+    /// Get the head of `ty`, returns false if the type could match impls with any head (ivars, generics, unbound paths)
+    static bool get(const TypeRef& ty, TypeHead& out);
+
+    bool operator<(const TypeHead& x) const {
+        return tag != x.tag ? tag < x.tag : sub < x.sub;
+    }
+};
+
 }
\ No newline at end of file
@@ -645,44 +645,54 @@ namespace {
                 this->m_in_expr --;
             }
             // External expression (has MIR)
-            else if( auto* mir = expr.get_ext_mir_mut() )
+            else if( expr.m_mir )
             {
-                for(auto& ty : mir->locals)
-                    this->visit_type(ty);
-                struct MirVisitor: public ::MIR::visit::VisitorMut
+                // MIR from crate metadata is only decoded when first used, so is bound at that point
+                const auto& crate = m_crate;
+                if( !expr.m_mir.add_post_load([&crate](::MIR::Function& mir){ Visitor(crate).visit_ext_mir(mir); }) )
                 {
-                    Visitor& upper_visitor;
-                    MirVisitor(Visitor& upper_visitor):
-                        upper_visitor(upper_visitor)
-                    {
-                    }
-                    void visit_type(::HIR::TypeRef& t) override {
-                        upper_visitor.visit_type(t);
-                    }
-                    void visit_path(::HIR::Path& p) override {
-                        upper_visitor.visit_path(p, ::HIR::Visitor::PathContext::VALUE);
-                    }
-                    bool visit_lvalue(::MIR::LValue& lv, ::MIR::visit::ValUsage u) override {
-                        if( lv.m_root.is_Static() ) {
-                            upper_visitor.visit_path(lv.m_root.as_Static(), ::HIR::Visitor::PathContext::VALUE);
-                        }
-                        return false;
-                    }
-                };
-                MirVisitor  mv(*this);
-                for(auto& block : mir->blocks)
-                {
-                    for(auto& stmt : block.statements)
-                    {
-                        mv.visit_stmt(stmt);
-                    }
-                    mv.visit_terminator(block.terminator);
+                    this->visit_ext_mir(*expr.m_mir);
                 }
             }
             else
             {
             }
         }
+
+        void visit_ext_mir(::MIR::Function& mir)
+        {
+            for(auto& ty : mir.locals)
+                this->visit_type(ty);
+            struct MirVisitor: public ::MIR::visit::VisitorMut
+            {
+                Visitor& upper_visitor;
+                MirVisitor(Visitor& upper_visitor):
+                    upper_visitor(upper_visitor)
+                {
+                }
+                void visit_type(::HIR::TypeRef& t) override {
+                    upper_visitor.visit_type(t);
+                }
+                void visit_path(::HIR::Path& p) override {
+                    upper_visitor.visit_path(p, ::HIR::Visitor::PathContext::VALUE);
+                }
+                bool visit_lvalue(::MIR::LValue& lv, ::MIR::visit::ValUsage u) override {
+                    if( lv.m_root.is_Static() ) {
+                        upper_visitor.visit_path(lv.m_root.as_Static(), ::HIR::Visitor::PathContext::VALUE);
+                    }
+                    return false;
+                }
+            };
+            MirVisitor  mv(*this);
+            for(auto& block : mir.blocks)
+            {
+                for(auto& stmt : block.statements)
+                {
+                    mv.visit_stmt(stmt);
+                }
+                mv.visit_terminator(block.terminator);
+            }
+        }
     };
 
     class Visitor_EnumSuperTraits:
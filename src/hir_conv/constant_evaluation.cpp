@@ -2686,6 +2686,8 @@ void ConvertHIR_ConstantEvaluate(::HIR::Crate& crate)
     {
         crate.m_root_module.m_mod_items.insert( mv$(new_ty_pair) );
     }
+    // Array sizes in impl headers are now known, so cached impl searches are stale
+    crate.m_trait_impl_cache.clear();
 }
 void ConvertHIR_ConstantEvaluate_Expr(const ::HIR::Crate& crate, const ::HIR::ItemPath& ip, ::HIR::ExprPtr& expr_ptr)
 {
@@ -2705,6 +2707,11 @@ void ConvertHIR_ConstantEvaluate_Enum(const ::HIR::Crate& crate, const ::HIR::It
 
     Expander::visit_enum_inner(crate, ip, mod, mod_path, item_name.c_str(), item);
 }
+::std::recursive_mutex& ConvertHIR_ConstantEvaluate_Lock()
+{
+    static ::std::recursive_mutex   s_lock;
+    return s_lock;
+}
 void ConvertHIR_ConstantEvaluate_MethodParams(
     const Span& sp,
     const ::HIR::Crate& crate, const HIR::SimplePath& mod_path, const ::HIR::GenericParams* impl_generics, const ::HIR::GenericParams* item_generics,
@@ -2712,6 +2719,8 @@ void ConvertHIR_ConstantEvaluate_MethodParams(
     ::HIR::PathParams& params
     )
 {
+    // NOTE: Called from typecheck, which can be checking other bodies in parallel
+    ::std::lock_guard<::std::recursive_mutex>   _lh(ConvertHIR_ConstantEvaluate_Lock());
     for(auto& v : params.m_values)
     {
         if(v.is_Unevaluated())
@@ -6,6 +6,7 @@
  * - Functions in the "HIR Conversion" group called by main
  */
 #pragma once
+#include <mutex>
 
 struct Span;
 namespace HIR {
@@ -35,4 +36,7 @@ void ConvertHIR_ConstantEvaluate_MethodParams(
     const ::HIR::GenericParams& params_def,
     ::HIR::PathParams& params
 );
+/// Lock held while evaluating on-demand (and generating the MIR that needs), as that mutates the crate
+/// - Recursive, as evaluation can require other bodies to be generated
+extern ::std::recursive_mutex& ConvertHIR_ConstantEvaluate_Lock();
 
@@ -923,19 +923,20 @@ namespace resolve_ufcs {
         auto new_end = ::std::remove_if(ig.generic.begin(), ig.generic.end(), [&ig,&fmt](::std::unique_ptr<T>& ty_impl) {
             const auto& type = ty_impl->m_type;  // Using field accesses in templates feels so dirty
             const ::HIR::SimplePath*    path = type.get_sort_path();
+            ::HIR::TypeHead head;
 
             if( path )
             {
                 DEBUG(*path << " += " << FMT_CB(os, fmt(os, *ty_impl)));
                 ig.named[*path].push_back(mv$(ty_impl));
             }
-            else if( type.data().is_Path() || type.data().is_Generic() )
+            else if( ::HIR::TypeHead::get(type, head) )
             {
-                return false;
+                ig.non_named[head].push_back(mv$(ty_impl));
             }
             else
             {
-                ig.non_named.push_back(mv$(ty_impl));
+                return false;
             }
             return true;
             });
@@ -956,7 +957,9 @@ namespace resolve_ufcs {
         for(const auto& e : src.named) {
             push_index_impl_group_list(dst.named[e.first], e.second);
         }
-        push_index_impl_group_list(dst.non_named, src.non_named);
+        for(const auto& e : src.non_named) {
+            push_index_impl_group_list(dst.non_named[e.first], e.second);
+        }
         push_index_impl_group_list(dst.generic  , src.generic  );
     }
     void push_index_impls(::HIR::Crate& dst, const ::HIR::Crate& src)
@@ -986,7 +989,9 @@ namespace resolve_ufcs {
         for(const auto& e : src.m_type_impls.named) {
             push_index_inherent_methods_list(icache, lang_Box, e.second);
         }
-        push_index_inherent_methods_list(icache, lang_Box, src.m_type_impls.non_named);
+        for(const auto& e : src.m_type_impls.non_named) {
+            push_index_inherent_methods_list(icache, lang_Box, e.second);
+        }
         push_index_inherent_methods_list(icache, lang_Box, src.m_type_impls.generic  );
     }
 }   // namespace ""
@@ -1001,6 +1006,8 @@ void ConvertHIR_ResolveUFCS(::HIR::Crate& crate)
 {
     Visitor exp { crate, true };
     exp.visit_crate( crate );
+    // Impl headers may have been updated, so cached impl searches are stale
+    crate.m_trait_impl_cache.clear();
 }
 
 void ConvertHIR_ResolveUFCS_SortImpls(::HIR::Crate& crate)
@@ -1009,7 +1016,7 @@ void ConvertHIR_ResolveUFCS_SortImpls(::HIR::Crate& crate)
     sort_impl_group<HIR::TypeImpl>(crate.m_type_impls,
         [](::std::ostream& os, const HIR::TypeImpl& i){ os << "impl" << i.m_params.fmt_args() << " " << i.m_type; }
         );
-    DEBUG("Type impl counts: " << crate.m_type_impls.named.size() << " path groups, " << crate.m_type_impls.non_named.size() << " primitive, " << crate.m_type_impls.generic.size() << " ungrouped");
+    DEBUG("Type impl counts: " << crate.m_type_impls.named.size() << " path groups, " << crate.m_type_impls.non_named.size() << " unnamed groups, " << crate.m_type_impls.generic.size() << " ungrouped");
     for(auto& impl_group : crate.m_trait_impls)
     {
         sort_impl_group<HIR::TraitImpl>(impl_group.second,
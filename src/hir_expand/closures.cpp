@@ -62,6 +62,7 @@ namespace {
         auto push_trait_impl = [&](const ::HIR::SimplePath& p, std::unique_ptr<::HIR::TraitImpl> ptr) {
             auto& trait_impl_list_r = crate.m_all_trait_impls[p].get_list_for_type_mut(ptr->m_type);
             trait_impl_list_r.push_back(ptr.get());
+            crate.m_trait_impl_cache.clear();
             auto& trait_impl_list   = crate.m_trait_impls[p].get_list_for_type_mut(ptr->m_type);
             trait_impl_list.push_back(mv$(ptr));
             };
@@ -890,6 +891,7 @@ namespace {
                     /*source module*/::HIR::SimplePath(m_resolve.m_crate.m_crate_name, {})
                     }));
                 const_cast<::HIR::Crate&>(m_resolve.m_crate).m_all_trait_impls[lang_Copy].get_list_for_type_mut(closure_type).push_back( v.back().get() );
+                m_resolve.m_crate.m_trait_impl_cache.clear();
             }
 
             // ---
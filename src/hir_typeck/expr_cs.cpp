@@ -10,6 +10,9 @@
 #include <hir/hir.hpp>
 #include <hir/visitor.hpp>
 #include <algorithm>    // std::find_if
+#include <chrono>
+#include <iomanip>
+#include <mutex>
 
 #include <hir_typeck/static.hpp>
 #include "helpers.hpp"
@@ -3381,6 +3384,7 @@ void Context::equate_types_coerce(const Span& sp, const ::HIR::TypeRef& l, ::HIR
         this->next_rule_idx ++,
         l.clone(), &node_ptr
         }));
+    this->m_stats.rules_created ++;
     DEBUG("++ " << *this->link_coerce.back());
     this->m_ivars.mark_change();
 }
@@ -3453,14 +3457,17 @@ void Context::equate_types_assoc(const Span& sp, const ::HIR::TypeRef& l,  const
         name,
         is_op
         });
+    this->m_stats.rules_created ++;
     DEBUG("++ " << this->link_assoc.back());
     this->m_ivars.mark_change();
 }
 void Context::add_revisit(::HIR::ExprNode& node) {
     this->to_visit.push_back( &node );
+    this->m_stats.rules_created ++;
 }
 void Context::add_revisit_adv(::std::unique_ptr<Revisitor> ent_ptr) {
     this->adv_revisits.push_back( mv$(ent_ptr) );
+    this->m_stats.rules_created ++;
 }
 void Context::require_sized(const Span& sp, const ::HIR::TypeRef& ty_)
 {
@@ -7048,9 +7055,49 @@ namespace
 
 
 
+namespace {
+    /// Solver statistics for one body (`-Z typeck-stats`)
+    struct BodyStats
+    {
+        ::std::string   name;
+        Context::Stats  stats;
+        size_t  ivar_count;
+        double  seconds;
+    };
+    bool    s_stats_enabled = false;
+    ::std::mutex    s_stats_lock;
+    ::std::vector<BodyStats>    s_body_stats;
+}
+
+void Typecheck_Expressions_EnableStats()
+{
+    s_stats_enabled = true;
+}
+void Typecheck_Expressions_ReportStats(::std::ostream& os, unsigned count)
+{
+    ::std::lock_guard<::std::mutex> _lh(s_stats_lock);
+    ::std::sort(s_body_stats.begin(), s_body_stats.end(), [](const BodyStats& a, const BodyStats& b){ return a.seconds > b.seconds; });
+    double total = 0;
+    for(const auto& e : s_body_stats)
+        total += e.seconds;
+
+    os << "Typecheck solver: " << s_body_stats.size() << " bodies, " << ::std::fixed << ::std::setprecision(3) << total << " s total\n";
+    os << ::std::setw(9) << "time (s)" << ::std::setw(8) << "passes" << ::std::setw(9) << "created" << ::std::setw(9) << "resolved"
+        << ::std::setw(8) << "ivars" << ::std::setw(10) << "fallbacks" << "  body\n";
+    for(size_t i = 0; i < s_body_stats.size() && i < count; i ++)
+    {
+        const auto& e = s_body_stats[i];
+        os << ::std::setw(9) << e.seconds << ::std::setw(8) << e.stats.passes << ::std::setw(9) << e.stats.rules_created
+            << ::std::setw(9) << e.stats.rules_resolved << ::std::setw(8) << e.ivar_count << ::std::setw(10) << e.stats.fallback_rounds
+            << "  " << e.name << "\n";
+    }
+    os.flush();
+}
+
 void Typecheck_Code_CS(const typeck::ModuleState& ms, t_args& args, const ::HIR::TypeRef& result_type, ::HIR::ExprPtr& expr)
 {
     TRACE_FUNCTION;
+    auto start_time = ::std::chrono::steady_clock::now();
 
     auto root_ptr = expr.into_unique();
     assert(!ms.m_mod_paths.empty());
@@ -7084,6 +7131,7 @@ void Typecheck_Code_CS(const typeck::ModuleState& ms, t_args& args, const ::HIR:
                     DEBUG("- Consumed coercion R" << ent->rule_idx << " " << ent->left_ty << " := " << src_ty);
 
                     context.link_coerce.erase( context.link_coerce.begin() + i );
+                    context.m_stats.rules_resolved ++;
                 }
                 else
                 {
@@ -7119,6 +7167,7 @@ void Typecheck_Code_CS(const typeck::ModuleState& ms, t_args& args, const ::HIR:
                         context.link_assoc[i] = mv$( context.link_assoc.back() );
                     }
                     context.link_assoc.pop_back();
+                    context.m_stats.rules_resolved ++;
                 }
                 else {
                     context.link_assoc[i] = mv$(rule);
@@ -7146,6 +7195,7 @@ void Typecheck_Code_CS(const typeck::ModuleState& ms, t_args& args, const ::HIR:
                 if( visitor.node_completed() ) {
                     DEBUG("- Completed " << &node << " - " << typeid(node).name());
                     it = context.to_visit.erase(it);
+                    context.m_stats.rules_resolved ++;
                 }
                 else {
                     ++ it;
@@ -7164,6 +7214,7 @@ void Typecheck_Code_CS(const typeck::ModuleState& ms, t_args& args, const ::HIR:
                 {
                     if( adv_revisit_remove_list[i] ) {
                         context.adv_revisits.erase( context.adv_revisits.begin() + i );
+                        context.m_stats.rules_resolved ++;
                     }
                 }
             }
@@ -7218,6 +7269,7 @@ void Typecheck_Code_CS(const typeck::ModuleState& ms, t_args& args, const ::HIR:
         // If nothing has changed, run check_ivar_poss again but allow it to assume is has all the options
         if( !context.m_ivars.peek_changed() )
         {
+            context.m_stats.fallback_rounds ++;
             // Check the possible equations
             DEBUG("--- IVar possibilities (fallback 1)");
             //for(unsigned int i = context.possible_ivar_vals.size(); i --; ) // NOTE: Ordering is a hack for libgit2
@@ -7261,6 +7313,7 @@ void Typecheck_Code_CS(const typeck::ModuleState& ms, t_args& args, const ::HIR:
                 if( visitor.node_completed() ) {
                     DEBUG("- Completed " << &node << " - " << typeid(node).name());
                     it = context.to_visit.erase(it);
+                    context.m_stats.rules_resolved ++;
                 }
                 else {
                     ++ it;
@@ -7279,6 +7332,7 @@ void Typecheck_Code_CS(const typeck::ModuleState& ms, t_args& args, const ::HIR:
                 {
                     if( adv_revisit_remove_list[i] ) {
                         context.adv_revisits.erase( context.adv_revisits.begin() + i );
+                        context.m_stats.rules_resolved ++;
                     }
                 }
             }
@@ -7362,6 +7416,7 @@ void Typecheck_Code_CS(const typeck::ModuleState& ms, t_args& args, const ::HIR:
             {
                 auto ent = mv$(context.link_coerce.front());
                 context.link_coerce.erase( context.link_coerce.begin() );
+                context.m_stats.rules_resolved ++;
 
                 const auto& sp = (*ent->right_node_ptr)->span();
                 auto& src_ty = (*ent->right_node_ptr)->m_res_type;
@@ -7386,6 +7441,7 @@ void Typecheck_Code_CS(const typeck::ModuleState& ms, t_args& args, const ::HIR:
     if( count == MAX_ITERATIONS ) {
         BUG(root_ptr->span(), "Typecheck ran for too many iterations, max - " << MAX_ITERATIONS);
     }
+    context.m_stats.passes = count;
 
     if( context.has_rules() )
     {
@@ -7521,5 +7577,17 @@ void Typecheck_Code_CS(const typeck::ModuleState& ms, t_args& args, const ::HIR:
         } v(ms, static_resolve);
         expr->visit(v);
     }
+
+    if( s_stats_enabled )
+    {
+        ::std::chrono::duration<double> elapsed = ::std::chrono::steady_clock::now() - start_time;
+        BodyStats   ent;
+        ent.name = ms.m_item_path ? FMT(*ms.m_item_path) : FMT(expr->span());
+        ent.stats = context.m_stats;
+        ent.ivar_count = context.m_ivars.m_ivars.size();
+        ent.seconds = elapsed.count();
+        ::std::lock_guard<::std::mutex> _lh(s_stats_lock);
+        s_body_stats.push_back(::std::move(ent));
+    }
 }
 
@@ -150,6 +150,18 @@ struct Context
 
     const ::HIR::SimplePath m_lang_Box;
 
+    /// Solver counters (reported by `-Z typeck-stats`)
+    struct Stats
+    {
+        unsigned    passes = 0;
+        /// Coercion, associated type and revisit rules added
+        unsigned    rules_created = 0;
+        /// Rules that were consumed (by being satisfied, or by the coercion fallback)
+        unsigned    rules_resolved = 0;
+        /// Passes that made no progress from the rules alone, and had to use ivar fallbacks/defaults
+        unsigned    fallback_rounds = 0;
+    } m_stats;
+
     Context(
         const ::HIR::Crate& crate,
         const ::HIR::GenericParams* impl_params,
@@ -10,6 +10,8 @@
 #include <hir/visitor.hpp>
 #include "expr_visit.hpp"
 #include <hir/expr_state.hpp>
+#include <thread_pool.hpp>
+#include <memory>
 
 void Typecheck_Code(const typeck::ModuleState& ms, t_args& args, const ::HIR::TypeRef& result_type, ::HIR::ExprPtr& expr) {
     if( expr.m_state->stage < ::HIR::ExprState::Stage::Typecheck )
@@ -105,14 +107,28 @@ namespace typeck {
 
 namespace {
 
+    /// A function body deferred to the parallel pass, along with a copy of the module state it was reached with
+    struct DeferredBody
+    {
+        ::HIR::Path path;
+        ::typeck::ModuleState   ms;
+        // `ms.m_current_trait` points at this (the visitor's copy is a temporary)
+        ::std::unique_ptr<::HIR::GenericPath>   current_trait;
+        t_args* args;
+        const ::HIR::TypeRef*   ret_ty;
+        ::HIR::ExprPtr* code;
+    };
 
     class OuterVisitor:
         public ::HIR::Visitor
     {
         ::typeck::ModuleState m_ms;
+        /// If non-null, non-`const` function bodies are pushed here instead of being checked immediately
+        ::std::vector<DeferredBody>*    m_deferred;
     public:
-        OuterVisitor(::HIR::Crate& crate):
-            m_ms(crate)
+        OuterVisitor(::HIR::Crate& crate, ::std::vector<DeferredBody>* deferred=nullptr):
+            m_ms(crate),
+            m_deferred(deferred)
         {
         }
 
@@ -202,8 +218,24 @@ namespace {
         // ------
         void visit_function(::HIR::ItemPath p, ::HIR::Function& item) override {
             auto _ = this->m_ms.set_item_generics(item.m_params);
+            auto _p = this->m_ms.set_item_path(p);
             if( item.m_code )
             {
+                // `const fn` bodies can be evaluated (and so checked on-demand) while checking other bodies, so
+                // they're always checked up-front.
+                if( m_deferred && !item.m_const )
+                {
+                    DEBUG("Function code " << p << " (deferred)");
+                    DeferredBody    body { p.get_full_path(), m_ms, nullptr, &item.m_args, &item.m_return, &item.m_code };
+                    body.ms.m_item_path = nullptr;  // Points at `path` once run
+                    if( m_ms.m_current_trait )
+                    {
+                        body.current_trait.reset(new ::HIR::GenericPath(m_ms.m_current_trait->clone()));
+                        body.ms.m_current_trait = body.current_trait.get();
+                    }
+                    m_deferred->push_back(::std::move(body));
+                    return ;
+                }
                 DEBUG("Function code " << p);
                 Typecheck_Code( m_ms, item.m_args, item.m_return, item.m_code );
             }
@@ -214,6 +246,7 @@ namespace {
         }
         void visit_static(::HIR::ItemPath p, ::HIR::Static& item) override {
             //auto _ = this->m_ms.set_item_generics(item.m_params);
+            auto _p = this->m_ms.set_item_path(p);
             if( item.m_value )
             {
                 DEBUG("Static value " << p);
@@ -223,6 +256,7 @@ namespace {
         }
         void visit_constant(::HIR::ItemPath p, ::HIR::Constant& item) override {
             auto _ = this->m_ms.set_item_generics(item.m_params);
+            auto _p = this->m_ms.set_item_path(p);
             if( item.m_value )
             {
                 DEBUG("Const value " << p);
@@ -232,6 +266,7 @@ namespace {
         }
         void visit_enum(::HIR::ItemPath p, ::HIR::Enum& item) override {
             auto _ = this->m_ms.set_item_generics(item.m_params);
+            auto _p = this->m_ms.set_item_path(p);
 
             if( auto* e = item.m_data.opt_Value() )
             {
@@ -251,8 +286,31 @@ namespace {
     };
 }
 
-void Typecheck_Expressions(::HIR::Crate& crate)
+void Typecheck_Expressions(::HIR::Crate& crate, unsigned num_threads)
 {
-    OuterVisitor    visitor { crate };
-    visitor.visit_crate( crate );
+    if( num_threads <= 1 )
+    {
+        OuterVisitor    visitor { crate };
+        visitor.visit_crate( crate );
+        return ;
+    }
+
+    // Check everything that other bodies can depend on (constants, statics, array sizes, `const fn`s) in
+    // order, and collect the remaining function bodies.
+    // - Each body has its own inference state, and only reads the signatures of other items, so they can
+    //   then be checked in any order.
+    ::std::vector<DeferredBody>  bodies;
+    {
+        OuterVisitor    visitor { crate, &bodies };
+        visitor.visit_crate( crate );
+    }
+    DEBUG(bodies.size() << " function bodies on " << num_threads << " threads");
+
+    ThreadPool::run(num_threads, bodies.size(), [&](unsigned /*worker_idx*/, size_t job_idx) {
+        auto& body = bodies[job_idx];
+        ::HIR::ItemPath ip(body.path);
+        TRACE_FUNCTION_F(ip);
+        body.ms.m_item_path = &ip;
+        Typecheck_Code( body.ms, *body.args, *body.ret_ty, *body.code );
+        });
 }
@@ -16,6 +16,8 @@ namespace typeck {
         const ::HIR::GenericPath*    m_current_trait;
         const ::HIR::GenericParams*   m_impl_generics;
         const ::HIR::GenericParams*   m_item_generics;
+        /// Path of the item being checked (only used for reporting, can be null)
+        const ::HIR::ItemPath*  m_item_path;
 
         ::std::vector< ::std::pair< const ::HIR::SimplePath*, const ::HIR::Trait* > >   m_traits;
         ::std::vector<HIR::SimplePath>  m_mod_paths;
@@ -24,7 +26,8 @@ namespace typeck {
             m_crate(crate),
             m_current_trait(nullptr),
             m_impl_generics(nullptr),
-            m_item_generics(nullptr)
+            m_item_generics(nullptr),
+            m_item_path(nullptr)
         {}
 
         template<typename T>
@@ -54,6 +57,12 @@ namespace typeck {
             return NullOnDrop<const ::HIR::GenericParams>(m_item_generics);
         }
 
+        NullOnDrop<const ::HIR::ItemPath> set_item_path(const ::HIR::ItemPath& p) {
+            assert( !m_item_path );
+            m_item_path = &p;
+            return NullOnDrop<const ::HIR::ItemPath>(m_item_path);
+        }
+
         void prepare_from_path(const ::HIR::ItemPath& ip);
 
         void push_traits(::HIR::ItemPath p, const ::HIR::Module& mod) {
@@ -7,6 +7,12 @@
  */
 #include "helpers.hpp"
 #include <algorithm>
+#include <mutex>
+
+namespace {
+    /// Protects the auto trait caches in `HIR::TraitMarkings::auto_impls` (bodies can be checked in parallel)
+    ::std::mutex    s_auto_impls_lock;
+}
 
 // --------------------------------------------------------------------
 // HMTypeInferrence
@@ -2675,7 +2681,7 @@ bool TraitResolution::find_trait_impls_crate(const Span& sp,
         StackHandle& operator=(const StackHandle&) = delete;
         ~StackHandle() { if(stack) stack->pop_back(); stack = nullptr; }
     };
-    static std::vector<StackEnt>    s_recurse_stack;
+    thread_local static std::vector<StackEnt>    s_recurse_stack;
     auto se = StackEnt(trait, params_ptr, type);
     // NOTE: Allow 1 level of recursion (EAT being run)
     if( std::count(s_recurse_stack.begin(), s_recurse_stack.end(), se) > 1 ) {
@@ -2691,7 +2697,7 @@ bool TraitResolution::find_trait_impls_crate(const Span& sp,
     if( m_crate.get_trait_by_path(sp, trait).m_is_marker )
     {
         // Detect recursion and return true if detected
-        static ::std::vector< ::std::tuple< const ::HIR::SimplePath*, const ::HIR::PathParams*, const ::HIR::TypeRef*> >    stack;
+        thread_local static ::std::vector< ::std::tuple< const ::HIR::SimplePath*, const ::HIR::PathParams*, const ::HIR::TypeRef*> >    stack;
         for(const auto& ent : stack ) {
             if( *::std::get<0>(ent) != trait )
                 continue ;
@@ -2727,19 +2733,27 @@ bool TraitResolution::find_trait_impls_crate(const Span& sp,
         // - Cache populated after destructure
         if( markings )
         {
-            auto it = markings->auto_impls.find( trait );
-            if( it != markings->auto_impls.end() )
+            // NOTE: The lock is released before calling `callback` (which can recurse into here)
+            enum { Unknown, Conditional, Impled, NotImpled } cached = Unknown;
             {
-                if( ! it->second.conditions.empty() ) {
-                    TODO(sp, "Conditional auto trait impl");
-                }
-                else if( it->second.is_impled ) {
-                    return callback( ImplRef(&type, params_ptr, &null_assoc), ::HIR::Compare::Equal );
-                }
-                else {
-                    return false;
+                ::std::lock_guard<::std::mutex> _lh(s_auto_impls_lock);
+                auto it = markings->auto_impls.find( trait );
+                if( it != markings->auto_impls.end() )
+                {
+                    cached = !it->second.conditions.empty() ? Conditional : (it->second.is_impled ? Impled : NotImpled);
                 }
             }
+            switch(cached)
+            {
+            case Unknown:
+                break;
+            case Conditional:
+                TODO(sp, "Conditional auto trait impl");
+            case Impled:
+                return callback( ImplRef(&type, params_ptr, &null_assoc), ::HIR::Compare::Equal );
+            case NotImpled:
+                return false;
+            }
         }
 
         // - Search for positive impls for this type
@@ -2807,6 +2821,7 @@ bool TraitResolution::find_trait_impls_crate(const Span& sp,
         {
             if( markings ) {
                 ASSERT_BUG(sp, cmp == ::HIR::Compare::Equal, "Auto trait with no params returned a fuzzy match from destructure - " << trait << " for " << type);
+                ::std::lock_guard<::std::mutex> _lh(s_auto_impls_lock);
                 markings->auto_impls.insert( ::std::make_pair(trait, ::HIR::TraitMarkings::AutoMarking { {}, true }) );
             }
             return callback( ImplRef(&type, params_ptr, &null_assoc), cmp );
@@ -2814,6 +2829,7 @@ bool TraitResolution::find_trait_impls_crate(const Span& sp,
         else
         {
             if( markings ) {
+                ::std::lock_guard<::std::mutex> _lh(s_auto_impls_lock);
                 markings->auto_impls.insert( ::std::make_pair(trait, ::HIR::TraitMarkings::AutoMarking { {}, false }) );
             }
             return false;
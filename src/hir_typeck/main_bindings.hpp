@@ -6,11 +6,16 @@
  * - Functions in HIR typecheck called by main
  */
 #pragma once
+#include <iosfwd>
 
 namespace HIR {
     class Crate;
 };
 
 extern void Typecheck_ModuleLevel(::HIR::Crate& crate);
-extern void Typecheck_Expressions(::HIR::Crate& crate);
+extern void Typecheck_Expressions(::HIR::Crate& crate, unsigned num_threads=1);
 extern void Typecheck_Expressions_Validate(::HIR::Crate& crate);
+/// Record solver statistics (passes, rules, ivars, time) for each body checked from now on
+extern void Typecheck_Expressions_EnableStats();
+/// Print the `count` slowest bodies recorded since `Typecheck_Expressions_EnableStats`
+extern void Typecheck_Expressions_ReportStats(::std::ostream& os, unsigned count);
@@ -790,5 +790,7 @@ void Typecheck_ModuleLevel(::HIR::Crate& crate)
 {
     Visitor v { crate };
     v.visit_crate(crate);
+    // Impl headers may have been updated, so cached impl searches are stale
+    crate.m_trait_impl_cache.clear();
 }
 
@@ -75,30 +75,35 @@ bool StaticTraitResolve::find_impl(
             }
             else {
             }
-            static ::HIR::TraitPath::assoc_list_t   assoc_unit;
-            if(assoc_unit.empty()) {
-                assoc_unit.insert(std::make_pair( RcString::new_interned("Discriminant"), HIR::TraitPath::AtyEqual {
+            // NOTE: Initialised via a function-local static so it's safe when resolving on multiple threads
+            static const ::HIR::TraitPath::assoc_list_t   assoc_unit = [&]() {
+                ::HIR::TraitPath::assoc_list_t  rv;
+                rv.insert(std::make_pair( RcString::new_interned("Discriminant"), HIR::TraitPath::AtyEqual {
                     m_lang_DiscriminantKind,
                     HIR::TypeRef::new_unit()
                     } ));
-            }
+                return rv;
+                }();
             return found_cb( ImplRef(&type, trait_params, &assoc_unit), false );
         }
         else if( TARGETVER_LEAST_1_54 && trait_path == m_lang_Pointee ) {
-            static ::HIR::TraitPath::assoc_list_t   assoc_unit;
-            static ::HIR::TraitPath::assoc_list_t   assoc_slice;
-            static RcString name_Metadata;
-            if(assoc_unit.empty()) {
-                name_Metadata = RcString::new_interned("Metadata");
-                assoc_unit.insert(std::make_pair( name_Metadata, HIR::TraitPath::AtyEqual {
+            static const RcString name_Metadata = RcString::new_interned("Metadata");
+            static const ::HIR::TraitPath::assoc_list_t   assoc_unit = [&]() {
+                ::HIR::TraitPath::assoc_list_t  rv;
+                rv.insert(std::make_pair( name_Metadata, HIR::TraitPath::AtyEqual {
                     m_lang_Pointee,
                     HIR::TypeRef::new_unit()
                     } ));
-                assoc_slice.insert(std::make_pair( name_Metadata, HIR::TraitPath::AtyEqual {
+                return rv;
+                }();
+            static const ::HIR::TraitPath::assoc_list_t   assoc_slice = [&]() {
+                ::HIR::TraitPath::assoc_list_t  rv;
+                rv.insert(std::make_pair( name_Metadata, HIR::TraitPath::AtyEqual {
                     m_lang_Pointee,
                     HIR::CoreType::Usize
                     } ));
-            }
+                return rv;
+                }();
             // Generics (or opaque ATYs)
             if( type.data().is_Generic() || (type.data().is_Path() && type.data().as_Path().binding.is_Opaque()) ) {
                 // If the type is `Sized` return `()` as the type
@@ -498,7 +503,7 @@ bool StaticTraitResolve::find_impl(
             return rv;
 
         // Detect recursion and return true if detected
-        static ::std::vector< ::std::tuple< const ::HIR::SimplePath*, const ::HIR::PathParams*, const ::HIR::TypeRef*> >    stack;
+        thread_local static ::std::vector< ::std::tuple< const ::HIR::SimplePath*, const ::HIR::PathParams*, const ::HIR::TypeRef*> >    stack;
         for(const auto& ent : stack ) {
             if( *::std::get<0>(ent) != trait_path )
                 continue ;
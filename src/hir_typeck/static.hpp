@@ -12,6 +12,7 @@
 #include "impl_ref.hpp"
 #include <range_vec_map.hpp>
 #include "resolve_common.hpp"
+#include <unordered_map>
 
 enum class MetadataType {
     Unknown,    // Unknown still
@@ -36,9 +37,10 @@ static inline std::ostream& operator<<(std::ostream& os, const MetadataType& x)
 class StaticTraitResolve:
     public TraitResolveCommon
 {
-    mutable ::std::map< ::HIR::TypeRef, bool >  m_copy_cache;
-    mutable ::std::map< ::HIR::TypeRef, bool >  m_clone_cache;
-    mutable ::std::map< ::HIR::TypeRef, bool >  m_drop_cache;
+    typedef ::std::unordered_map< ::HIR::TypeRef, bool, ::std::hash<::HIR::TypeRef>, ::HIR::TypeRefOrdEqual >  t_type_flag_cache;
+    mutable t_type_flag_cache   m_copy_cache;
+    mutable t_type_flag_cache   m_clone_cache;
+    mutable t_type_flag_cache   m_drop_cache;
     mutable ::std::map< ::HIR::Path, HIR::TypeRef>  m_aty_cache;
 
 public:
@@ -9,18 +9,24 @@
 
 #include <cstring>
 #include <ostream>
+#include <atomic>
+#include <cstdint>
+#include <functional>   // std::hash
 #include "../common.hpp"
 
 class RcString
 {
     struct Inner {
-        unsigned int    refcount;
+        ::std::atomic<unsigned int> refcount;
         unsigned int    size;
-        unsigned int    ordering;   // Populated only for interned strings, 0 otherwise
+        unsigned int    symbol_id;  // Populated only for interned strings (stable, never reused), 0 otherwise
+        // The following are only populated for interned strings
+        size_t  hash;   // Cached `std::hash` value
+        uint64_t    ord_prefix; // First 8 bytes (big-endian, zero padded), gives the lexical order of most pairs in one compare
         unsigned int    data[1];    // Actually arbitary
     }*  m_ptr;
 public:
-    RcString():
+    constexpr RcString():
         m_ptr(nullptr)
     {}
     RcString(const char* s, size_t len);
@@ -40,6 +46,8 @@ public:
     static RcString new_interned(const char* s) {
         return new_interned(s, ::std::strlen(s));
     }
+    /// Intern a batch of (pointer, length) strings
+    static ::std::vector<RcString> new_interned_bulk(const ::std::vector<::std::pair<const char*,size_t>>& strings);
 
     RcString(const RcString& x):
         m_ptr(x.m_ptr)
@@ -78,7 +86,9 @@ public:
     const char* begin() const { return c_str(); }
     const char* end() const { return c_str() + size(); }
 
-    bool is_interned() const { return m_ptr && m_ptr->ordering != 0; }
+    bool is_interned() const { return m_ptr && m_ptr->symbol_id != 0; }
+    /// Unique ID of an interned string (assigned in interning order, so not related to the lexical order)
+    unsigned int symbol_id() const { return m_ptr ? m_ptr->symbol_id : 0; }
     size_t size() const { return m_ptr ? m_ptr->size : 0; }
     const char* c_str() const {
         if( m_ptr )
@@ -97,7 +107,12 @@ public:
     }
 
     Ordering ord(const char* s, size_t l) const;
-    Ordering ord_interned(const RcString& s) const;
+    Ordering ord_interned(const RcString& s) const {
+        // Interned strings are unique, so (as the pointers differ) the contents differ
+        if( m_ptr->ord_prefix != s.m_ptr->ord_prefix )
+            return ::ord(m_ptr->ord_prefix, s.m_ptr->ord_prefix);
+        return ord(s.c_str(), s.size());
+    }
 
     Ordering ord(const RcString& s) const {
         if( m_ptr == s.m_ptr )
@@ -133,6 +148,7 @@ public:
     bool operator!=(const char* s) const { return this->ord(s) != OrdEqual; }
 
     friend ::std::ostream& operator<<(::std::ostream& os, const RcString& x);
+    friend struct ::std::hash<RcString>;
 
     friend bool operator==(const char* a, const RcString& b) {
         return b == a;
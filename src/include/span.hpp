@@ -10,6 +10,8 @@
 #include <rc_string.hpp>
 #include <functional>
 #include <memory>
+#include <atomic>
+#include <cstdint>
 
 enum ErrorType
 {
@@ -30,79 +32,63 @@ struct ProtoSpan
     unsigned int start_line;
     unsigned int start_ofs;
 };
+/// Handle to a source location, an index into the global source map
+///
+/// Spans are created constantly and copied into most AST/HIR/MIR nodes, so they're just an index (trivially
+/// copied, no reference counting). The source map is append-only and de-duplicated, so a macro expansion's
+/// parent chain is only recorded once however many spans refer to it.
 struct Span
 {
 private:
-    SpanInner*  m_ptr;
-    static SpanInner    s_empty_span;
+    /// Index into the source map, zero is the empty span
+    uint32_t    m_idx;
+
+    static const unsigned CHUNK_BITS = 16;
+    /// The source map, as fixed-size chunks (allocated on demand) so entries never move
+    static ::std::atomic<SpanInner*>    s_chunks[1 << (32 - CHUNK_BITS)];
+    static const SpanInner& get(uint32_t idx);
+    static uint32_t add(Span parent, RcString filename, unsigned int start_line, unsigned int start_ofs,  unsigned int end_line, unsigned int end_ofs);
 public:
-    Span():
-        m_ptr(&s_empty_span)
+    constexpr Span():
+        m_idx(0)
     {}
     Span(Span parent, RcString filename, unsigned int start_line, unsigned int start_ofs,  unsigned int end_line, unsigned int end_ofs);
     Span(Span parent, const Position& position);
-    ~Span();
-
-    Span(const Span& x);
-    Span(Span&& x):
-        m_ptr(x.m_ptr)
-    {
-        x.m_ptr = nullptr;
-    }
-
-    Span& operator=(const Span& x)
-    {
-        this->~Span();
-        new (this) Span(x);
-        return *this;
-    }
-    Span& operator=(Span&& x)
-    {
-        this->~Span();
-        new (this) Span(std::move(x));
-        return *this;
-    }
-
-    bool operator==(const Span& x) const { return m_ptr == x.m_ptr; }
+
+    bool operator==(const Span& x) const { return m_idx == x.m_idx; }
     bool operator!=(const Span& x) const { return !(*this == x); }
 
-    const SpanInner& operator*() const { return *m_ptr; }
-    const SpanInner* operator->() const { return m_ptr; }
+    const SpanInner& operator*() const;
+    const SpanInner* operator->() const;
 
     void bug(::std::function<void(::std::ostream&)> msg) const;
     void error(ErrorType tag, ::std::function<void(::std::ostream&)> msg) const;
     void warning(WarningType tag, ::std::function<void(::std::ostream&)> msg) const;
     void note(::std::function<void(::std::ostream&)> msg) const;
 
+    /// Number of distinct spans in the source map
+    static size_t source_map_size();
+
     friend ::std::ostream& operator<<(::std::ostream& os, const Span& sp);
 };
+/// An entry in the source map
 struct SpanInner
 {
-    friend struct Span;
-private:
-    size_t  reference_count;
-public:
     Span    parent_span;
     RcString    filename;
 
-    unsigned int start_line;
-    unsigned int start_ofs;
-    unsigned int end_line;
-    unsigned int end_ofs;
+    unsigned int start_line = 0;
+    unsigned int start_ofs = 0;
+    unsigned int end_line = 0;
+    unsigned int end_ofs = 0;
 
-private:
-    static SpanInner* alloc(Span parent, RcString filename, unsigned int start_line, unsigned int start_ofs,  unsigned int end_line, unsigned int end_ofs) {
-        auto* rv = new SpanInner();
-        rv->reference_count = 1;
-        rv->parent_span = parent;
-        rv->filename = ::std::move(filename);
-        rv->start_line = start_line;
-        rv->start_ofs = start_ofs;
-        rv->end_line = end_line;
-        rv->end_ofs = end_ofs;
-        return rv;
-    }
+    constexpr SpanInner() {}
 };
+inline const SpanInner& Span::get(uint32_t idx) {
+    return s_chunks[idx >> CHUNK_BITS].load(::std::memory_order_relaxed)[idx & ((1 << CHUNK_BITS) - 1)];
+}
+inline const SpanInner& Span::operator*() const { return get(m_idx); }
+inline const SpanInner* Span::operator->() const { return &get(m_idx); }
 
 template<typename T>
 struct Spanned
@@ -0,0 +1,25 @@
+/*
+ * MRustC - Rust Compiler
+ * - By John Hodge (Mutabah/thePowersGang)
+ *
+ * include/thread_pool.hpp
+ * - Work-stealing pool for running independent jobs in parallel
+ */
+#pragma once
+#include <functional>
+#include <cstddef>
+
+class ThreadPool
+{
+public:
+    /// Callback type, given the index of the worker running the job and the job index
+    typedef ::std::function<void(unsigned int worker_idx, size_t job_idx)>    job_cb_t;
+
+    /// Run jobs `0 .. job_count` across `num_threads` workers, returning once all have completed.
+    ///
+    /// Each worker starts with a contiguous slice of the job indexes, and steals from the
+    /// back of other workers' slices once its own is exhausted.
+    /// If a job throws, no further jobs are started and the first exception is re-thrown on the
+    /// calling thread. With `num_threads <= 1` the jobs are run in order on the calling thread.
+    static void run(unsigned int num_threads, size_t job_count, job_cb_t cb);
+};
@@ -11,6 +11,8 @@
 #include <parse/ttstream.hpp>
 #include <parse/common.hpp>
 #include <limits.h>
+#include <algorithm>
+#include <iterator>
 #include "pattern_checks.hpp"
 #include <parse/interpolated_fragment.hpp>
 #include <ast/expr.hpp>
@@ -701,6 +703,18 @@ namespace
         size_t position() const {
             return m_consume_count;
         }
+        /// Returns true if the next token was produced by splitting a compound token (e.g. `>>`)
+        bool has_faked_next() const {
+            return m_faked_next.type() != TOK_NULL;
+        }
+        /// Move this stream to the position of another stream over the same tree
+        void restore(const TokenStreamRO& x) {
+            assert(&m_tt == &x.m_tt);
+            m_offsets = x.m_offsets;
+            m_active_offset = x.m_active_offset;
+            m_faked_next = x.m_faked_next.clone();
+            m_consume_count = x.m_consume_count;
+        }
     };
 
     // Consume an entire TT
@@ -1819,14 +1833,86 @@ namespace
     }
 }
 
+namespace {
+    /// Fragment parse results for a single macro input, shared between all arms tried against it
+    ///
+    /// Arms of the same macro often start with the same fragments (e.g. `$e:expr`), so this avoids
+    /// re-parsing those for every arm.
+    class FragmentCache
+    {
+        struct Entry {
+            bool    success;
+            TokenStreamRO   end;
+        };
+        ::std::map< ::std::pair<size_t, MacroPatEnt::Type>, Entry>  m_entries;
+    public:
+        bool consume(TokenStreamRO& lex, MacroPatEnt::Type type)
+        {
+            // A split token (e.g. the second `>` of `>>`) shares its position with the first, so don't cache
+            if( lex.has_faked_next() )
+                return consume_from_frag(lex, type);
+
+            auto key = ::std::make_pair(lex.position(), type);
+            auto it = m_entries.find(key);
+            if( it == m_entries.end() )
+            {
+                auto lc = lex.clone();
+                bool success = consume_from_frag(lc, type);
+                it = m_entries.insert(::std::make_pair(key, Entry { success, mv$(lc) })).first;
+            }
+            else
+            {
+                DEBUG("Cached " << type << " @" << key.first << " = " << it->second.success);
+            }
+            lex.restore(it->second.end);
+            return it->second.success;
+        }
+    };
+
+    ::std::unique_ptr<MacroRulesDispatch> Macro_BuildDispatch(const MacroRules& rules)
+    {
+        ::std::unique_ptr<MacroRulesDispatch>   rv { new MacroRulesDispatch() };
+        for(unsigned i = 0; i < rules.m_rules.size(); i ++)
+        {
+            const auto& pat = rules.m_rules[i].m_pattern;
+            if( pat.empty() )
+                rv->by_first_token[TOK_EOF].push_back(i);
+            else if( const auto* e = pat[0].opt_ExpectTok() )
+                rv->by_first_token[e->type()].push_back(i);
+            else
+                rv->any_first_token.push_back(i);
+        }
+        return rv;
+    }
+}
+
 unsigned int Macro_InvokeRules_MatchPattern(const Span& sp, const MacroRules& rules, TokenTree input, const AST::Crate& crate, AST::Module& mod,  ParameterMappings& bound_tts)
 {
     TRACE_FUNCTION_F(rules.m_rules.size() << " options");
     ASSERT_BUG(sp, rules.m_rules.size() > 0, "Empty macro_rules set");
 
+    if( !rules.m_dispatch )
+    {
+        rules.m_dispatch = Macro_BuildDispatch(rules);
+    }
+
+    // Only arms that expect the input's first token (or that start with a fragment) can match,
+    // try those in declaration order and stop at the first that matches.
+    ::std::vector<unsigned> candidates;
+    {
+        static const ::std::vector<unsigned>    empty;
+        auto it = rules.m_dispatch->by_first_token.find( TokenStreamRO(input).next() );
+        const auto& keyed = (it != rules.m_dispatch->by_first_token.end() ? it->second : empty);
+        const auto& any = rules.m_dispatch->any_first_token;
+        candidates.reserve(keyed.size() + any.size());
+        ::std::merge(keyed.begin(), keyed.end(), any.begin(), any.end(), ::std::back_inserter(candidates));
+    }
+    DEBUG(candidates.size() << " candidate arms");
+
+    FragmentCache   frag_cache;
     ::std::vector< ::std::pair<size_t, ::std::vector<bool>> >    matches;
     ::std::vector< std::pair<size_t, eTokenType> >  fail_pos;
-    for(size_t i = 0; i < rules.m_rules.size(); i ++)
+    for(auto i : candidates)
     {
         auto lex = TokenStreamRO(input);
         auto arm_stream = MacroPatternStream(rules.m_rules[i].m_pattern);
@@ -1851,7 +1937,7 @@ unsigned int Macro_InvokeRules_MatchPattern(const Span& sp, const MacroRules& ru
                 for(const auto& check : e->ents)
                 {
                     if( check.ty != MacroPatEnt::PAT_TOKEN ) {
-                        if( !consume_from_frag(lc, check.ty)  )
+                        if( !frag_cache.consume(lc, check.ty)  )
                         {
                             rv = false;
                             break;
@@ -1888,7 +1974,7 @@ unsigned int Macro_InvokeRules_MatchPattern(const Span& sp, const MacroRules& ru
             else if( const auto* e = pat.opt_ExpectPat() )
             {
                 DEBUG("Arm " << i << " @" << pos << " ExpectPat(" << e->type << " => $" << e->idx << ")");
-                if( !consume_from_frag(lex, e->type) )
+                if( !frag_cache.consume(lex, e->type) )
                 {
                     fail = true;
                     break;
@@ -1905,6 +1991,8 @@ unsigned int Macro_InvokeRules_MatchPattern(const Span& sp, const MacroRules& ru
         {
             matches.push_back( ::std::make_pair(i, arm_stream.take_history()) );
             DEBUG(i << " MATCHED");
+            // The first matching arm is always the one used
+            break;
         }
         else
         {
@@ -1923,7 +2011,6 @@ unsigned int Macro_InvokeRules_MatchPattern(const Span& sp, const MacroRules& ru
     {
         // yay!
 
-        // NOTE: There can be multiple arms active, take the first.
         auto i = matches[0].first;
         const auto& history = matches[0].second;
         DEBUG("Evalulating arm " << i);
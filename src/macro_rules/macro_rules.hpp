@@ -175,6 +175,16 @@ struct MacroRulesArm
     MacroRulesArm& operator=(MacroRulesArm&&) = default;
 };
 
+/// Arm pre-selection table for a `MacroRules`, built on first invocation
+struct MacroRulesDispatch
+{
+    /// Arms that start with a literal token, indexed by that token's type (each list in declaration order)
+    /// - Arms with an empty pattern are listed under `TOK_EOF`
+    ::std::map<eTokenType, ::std::vector<unsigned>>  by_first_token;
+    /// Arms that start with a fragment or repetition, so could match any input
+    ::std::vector<unsigned> any_first_token;
+};
+
 /// A sigle 'macro_rules!' block
 class MacroRules
 {
@@ -191,6 +201,9 @@ public:
     /// Expansion rules
     ::std::vector<MacroRulesArm>  m_rules;
 
+    /// Cached arm selection table (see `Macro_InvokeRules_MatchPattern`)
+    mutable ::std::unique_ptr<MacroRulesDispatch>   m_dispatch;
+
     MacroRules()
     {
     }
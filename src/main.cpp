@@ -7,8 +7,13 @@
  */
 #include <iostream>
 #include <iomanip>
+#include <fstream>
 #include <string>
 #include <set>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
 #include <version.hpp>
 #include <string_view.hpp>
 #include "parse/lex.hpp"
@@ -20,6 +25,7 @@
 #include <main_bindings.hpp>
 #include "resolve/main_bindings.hpp"
 #include "hir/main_bindings.hpp"
+#include "hir/trait_impl_cache.hpp"
 #include "hir_conv/main_bindings.hpp"
 #include "hir_typeck/main_bindings.hpp"
 #include "hir_expand/main_bindings.hpp"
@@ -29,12 +35,15 @@
 
 #include "expand/cfg.hpp"
 #include <target_detect.h>	// tools/common/target_detect.h
+#include <jobserver.h>	// tools/common/jobserver.h
 #include <debug_inner.hpp>
 
 #ifdef _WIN32
 # define NOGDI
 # include <Windows.h>
 # include <DbgHelp.h>
+#else
+# include <sys/resource.h>
 #endif
 
 TargetVersion	gTargetVersion = TargetVersion::Rustc1_29;
@@ -72,6 +81,8 @@ struct ProgramParams
     ::std::string   target_saveback;
     // NOTE: if true, no parse/compilation performed (target is loaded though)
     bool    print_cfgs = false;
+    // Write per-phase timing/memory statistics to `<outfile>.timings.json`
+    bool    emit_timings_json = false;
 
     ::std::vector<const char*> lib_search_dirs;
     ::std::vector<const char*> libraries;
@@ -87,11 +98,31 @@ struct ProgramParams
         bool dump_ast = false;
         bool dump_hir = false;
         bool dump_mir = false;
+
+        // Worker threads used by the parallelised phases (1 = everything on the main thread)
+        unsigned int num_threads = 1;
+
+        // Number of bodies to list in the typecheck solver report (0 = no report)
+        unsigned int typeck_stats_count = 0;
+
+        // Store emitted .hir files zlib-compressed (`false` writes the raw format, which is mapped on load)
+        bool compress_hir = true;
+
+        // Link to generic instances exported by upstream crates instead of generating local copies
+        // (-1 = default, enabled only when not optimising, as the linked copies can't be inlined)
+        int share_generics = -1;
     } debug;
     struct {
         ::std::string   codegen_type;
         ::std::string   emit_build_command;
         ::std::string   panic_type;
+        // (0 = default, one unit unless `-C incremental` is set)
+        unsigned int    codegen_units = 0;
+        ::std::string   incremental_dir;
+        bool    emit_noalias = false;
+        bool    lto = false;
+        ::std::string   profile_generate_dir;
+        ::std::string   profile_use_dir;
     } codegen;
 
     ProgramParams(int argc, char *argv[]);
@@ -99,14 +130,225 @@ struct ProgramParams
     void show_help() const;
 };
 
+// --------------------------------------------------------------------
+// Per-phase resource usage (for `--timings=json`)
+// --------------------------------------------------------------------
+namespace {
+    // Allocation counters, updated by the `operator new` replacement below (only when `--timings` is enabled)
+    // - Each thread uses its own slot (shared only if there are more threads than slots), so the parallel passes
+    //   don't all contend on one cache line.
+    struct alignas(64) AllocCounterSlot
+    {
+        ::std::atomic<uint64_t> count;
+        ::std::atomic<uint64_t> bytes;
+    };
+    const unsigned NUM_ALLOC_COUNTER_SLOTS = 64;
+    AllocCounterSlot    g_alloc_counters[NUM_ALLOC_COUNTER_SLOTS];
+    ::std::atomic<unsigned> g_alloc_counter_next_slot;
+    thread_local unsigned   t_alloc_counter_slot = g_alloc_counter_next_slot.fetch_add(1, ::std::memory_order_relaxed) % NUM_ALLOC_COUNTER_SLOTS;
+
+    struct AllocCounts
+    {
+        uint64_t    count = 0;
+        uint64_t    bytes = 0;
+
+        static AllocCounts get()
+        {
+            AllocCounts rv;
+            for(const auto& s : g_alloc_counters)
+            {
+                rv.count += s.count.load(::std::memory_order_relaxed);
+                rv.bytes += s.bytes.load(::std::memory_order_relaxed);
+            }
+            return rv;
+        }
+    };
+
+    struct MemoryUsage
+    {
+        size_t  current_kb = 0;
+        size_t  peak_kb = 0;
+
+        static MemoryUsage get()
+        {
+            MemoryUsage rv;
+#if defined(__linux__)
+            ::std::ifstream is("/proc/self/status");
+            ::std::string   line;
+            while( ::std::getline(is, line) )
+            {
+                if( line.compare(0, 6, "VmRSS:") == 0 )
+                    rv.current_kb = ::std::strtoull(line.c_str() + 6, nullptr, 10);
+                else if( line.compare(0, 6, "VmHWM:") == 0 )
+                    rv.peak_kb = ::std::strtoull(line.c_str() + 6, nullptr, 10);
+            }
+#elif defined(_WIN32)
+            // TODO: `GetProcessMemoryInfo` (needs psapi)
+#else
+            // Only the peak is available portably
+            struct rusage   ru;
+            if( getrusage(RUSAGE_SELF, &ru) == 0 )
+            {
+# ifdef __APPLE__
+                rv.peak_kb = ru.ru_maxrss / 1024;
+# else
+                rv.peak_kb = ru.ru_maxrss;
+# endif
+            }
+#endif
+            return rv;
+        }
+    };
+
+    struct PhaseTiming
+    {
+        const char* name;
+        double  wall_s;
+        double  cpu_s;
+        // Memory usage at the end of the phase
+        MemoryUsage mem;
+        uint64_t    alloc_count;
+        uint64_t    alloc_bytes;
+    };
+    bool    g_timings_enabled = false;
+    ::std::vector<PhaseTiming>  g_phase_timings;
+
+    class PhaseTimer
+    {
+        const char* m_name;
+        ::std::chrono::steady_clock::time_point m_wall_start;
+        clock_t m_cpu_start;
+        AllocCounts m_alloc_start;
+    public:
+        PhaseTimer(const char* name):
+            m_name(name),
+            m_wall_start(::std::chrono::steady_clock::now()),
+            m_cpu_start(clock()),
+            m_alloc_start(AllocCounts::get())
+        {
+        }
+        ~PhaseTimer()
+        {
+            if( !g_timings_enabled )
+                return ;
+            PhaseTiming rec;
+            rec.name = m_name;
+            rec.wall_s = ::std::chrono::duration<double>(::std::chrono::steady_clock::now() - m_wall_start).count();
+            rec.cpu_s = static_cast<double>(clock() - m_cpu_start) / static_cast<double>(CLOCKS_PER_SEC);
+            auto allocs = AllocCounts::get();
+            rec.alloc_count = allocs.count - m_alloc_start.count;
+            rec.alloc_bytes = allocs.bytes - m_alloc_start.bytes;
+            // NOTE: Done after reading the counters, as this allocates
+            rec.mem = MemoryUsage::get();
+            g_phase_timings.push_back(rec);
+        }
+    };
+
+    void write_json_string(::std::ostream& os, const ::std::string& s)
+    {
+        os << '"';
+        for(char c : s)
+        {
+            switch(c)
+            {
+            case '"':   os << "\\\"";   break;
+            case '\\':  os << "\\\\";  break;
+            case '\n':  os << "\\n";   break;
+            default:
+                if( static_cast<unsigned char>(c) < 0x20 )
+                    os << "\\u" << ::std::hex << ::std::setw(4) << ::std::setfill('0') << unsigned(c) << ::std::dec << ::std::setfill(' ');
+                else
+                    os << c;
+                break;
+            }
+        }
+        os << '"';
+    }
+    void Timings_WriteJson(const ::std::string& filename, const ::std::string& infile, const ::std::string& outfile)
+    {
+        ::std::ofstream os(filename);
+        if( !os.good() )
+        {
+            ::std::cerr << "Unable to open " << filename << " for writing" << ::std::endl;
+            return ;
+        }
+        os << ::std::fixed << ::std::setprecision(6);
+        os << "{\n";
+        os << "  \"mrustc_version\": "; write_json_string(os, Version_GetString()); os << ",\n";
+        os << "  \"input\": "; write_json_string(os, infile); os << ",\n";
+        os << "  \"output\": "; write_json_string(os, outfile); os << ",\n";
+        os << "  \"phases\": [\n";
+        double  total_wall = 0, total_cpu = 0;
+        for(size_t i = 0; i < g_phase_timings.size(); i ++)
+        {
+            const auto& e = g_phase_timings[i];
+            total_wall += e.wall_s;
+            total_cpu += e.cpu_s;
+            os << "    {\"name\": "; write_json_string(os, e.name);
+            os << ", \"wall_s\": " << e.wall_s << ", \"cpu_s\": " << e.cpu_s;
+            os << ", \"rss_kb\": " << e.mem.current_kb << ", \"peak_rss_kb\": " << e.mem.peak_kb;
+            os << ", \"alloc_count\": " << e.alloc_count << ", \"alloc_bytes\": " << e.alloc_bytes;
+            os << "}" << (i+1 < g_phase_timings.size() ? "," : "") << "\n";
+        }
+        os << "  ],\n";
+        auto mem = MemoryUsage::get();
+        os << "  \"total\": {\"wall_s\": " << total_wall << ", \"cpu_s\": " << total_cpu;
+        os << ", \"peak_rss_kb\": " << mem.peak_kb;
+        auto allocs = AllocCounts::get();
+        os << ", \"alloc_count\": " << allocs.count << ", \"alloc_bytes\": " << allocs.bytes;
+        os << "},\n";
+        os << "  \"trait_impl_cache\": {\"hits\": " << ::HIR::TraitImplCache::s_hits.load() << ", \"misses\": " << ::HIR::TraitImplCache::s_misses.load() << "},\n";
+        os << "  \"source_map\": {\"spans\": " << Span::source_map_size() << ", \"bytes\": " << Span::source_map_size() * sizeof(SpanInner) << "}\n";
+        os << "}\n";
+    }
+}
+
+// Counting replacement for the global allocator (the array and nothrow forms forward to this)
+// - Kept out of line, otherwise GCC inlines the `free` into callers and warns (-Wmismatched-new-delete) that it
+//   is given a pointer from `operator new`
+#ifdef _MSC_VER
+# define ALLOCATOR_NOINLINE __declspec(noinline)
+#else
+# define ALLOCATOR_NOINLINE __attribute__((noinline))
+#endif
+ALLOCATOR_NOINLINE void* operator new(size_t size)
+{
+    // NOTE: `g_timings_enabled` is only set before any worker threads are started
+    if( g_timings_enabled )
+    {
+        auto& slot = g_alloc_counters[t_alloc_counter_slot];
+        slot.count.fetch_add(1, ::std::memory_order_relaxed);
+        slot.bytes.fetch_add(size, ::std::memory_order_relaxed);
+    }
+    for(;;)
+    {
+        if( void* rv = ::std::malloc(size ? size : 1) )
+            return rv;
+        auto handler = ::std::get_new_handler();
+        if( !handler )
+            throw ::std::bad_alloc();
+        handler();
+    }
+}
+ALLOCATOR_NOINLINE void operator delete(void* ptr) noexcept
+{
+    ::std::free(ptr);
+}
+ALLOCATOR_NOINLINE void operator delete(void* ptr, size_t ) noexcept
+{
+    ::std::free(ptr);
+}
+
 template <typename Rv, typename Fcn>
 Rv CompilePhase(const char *name, Fcn f) {
     DebugTimedPhase timed_phase(name);
+    PhaseTimer  timer(name);
     return f();
 }
 template <typename Fcn>
 void CompilePhaseV(const char *name, Fcn f) {
     DebugTimedPhase timed_phase(name);
+    PhaseTimer  timer(name);
     f();
 }
 
@@ -234,9 +476,26 @@ int main(int argc, char *argv[])
     init_debug_list();
     ProgramParams   params(argc, argv);
 
+    // Write out the timing report however compilation ends (early stop or completion)
+    struct TimingsReport {
+        const ProgramParams& params;
+        ~TimingsReport() {
+            if( params.emit_timings_json ) {
+                const auto& base = params.outfile != "" ? params.outfile : params.infile;
+                Timings_WriteJson(base + ".timings.json", params.infile, params.outfile);
+            }
+        }
+    } timings_report { params };
+    g_timings_enabled = params.emit_timings_json;
+
     // Set up cfg values
     CompilePhaseV("Setup", [&]() {
         Cfg_SetValue("rust_compiler", "mrustc");
+        // Share the C compiler parallelism with the invoking build tool (if it provided a jobserver)
+        JobServer::attach_from_env();
+        if( params.debug.typeck_stats_count > 0 ) {
+            Typecheck_Expressions_EnableStats();
+        }
         Cfg_SetValueCb("feature", [&params](const ::std::string& s) {
             return params.features.count(s) != 0;
             });
@@ -634,8 +893,11 @@ int main(int argc, char *argv[])
             });
         // Check the rest of the expressions (including function bodies)
         CompilePhaseV("Typecheck Expressions", [&]() {
-            Typecheck_Expressions(*hir_crate);
+            Typecheck_Expressions(*hir_crate, params.debug.num_threads);
             });
+        if( params.debug.typeck_stats_count > 0 ) {
+            Typecheck_Expressions_ReportStats(::std::cout, params.debug.typeck_stats_count);
+        }
         // === HIR Expansion ===
         // Annotate how each node's result is used
         CompilePhaseV("Expand HIR Annotate", [&]() {
@@ -716,7 +978,7 @@ int main(int argc, char *argv[])
 
         // Optimise the MIR
         CompilePhaseV("MIR Optimise", [&]() {
-            MIR_OptimiseCrate(*hir_crate, params.debug.disable_mir_optimisations);
+            MIR_OptimiseCrate(*hir_crate, params.debug.disable_mir_optimisations, params.debug.num_threads);
             });
 
         if( params.debug.dump_mir )
@@ -749,7 +1011,23 @@ int main(int argc, char *argv[])
         TransOptions    trans_opt;
         trans_opt.mode = params.codegen.codegen_type == "" ? "c" : params.codegen.codegen_type;
         trans_opt.build_command_file = params.codegen.emit_build_command;
+        trans_opt.codegen_units = params.codegen.codegen_units;
+        trans_opt.incremental_dir = params.codegen.incremental_dir;
+        if( trans_opt.codegen_units == 0 )
+        {
+            trans_opt.codegen_units = 1;
+            // Incremental reuse is per-unit, so a single unit would never be reused after any change
+            // - Only when the unit count wasn't given, an explicit `-C codegen-units=1` is honoured
+            if( !trans_opt.incremental_dir.empty() ) {
+                trans_opt.codegen_units = 16;
+                ::std::cerr << "note: -C incremental without -C codegen-units, using 16 codegen units" << ::std::endl;
+            }
+        }
         trans_opt.opt_level = params.opt_level;
+        trans_opt.emit_noalias = params.codegen.emit_noalias;
+        trans_opt.lto = params.codegen.lto;
+        trans_opt.profile_generate_dir = params.codegen.profile_generate_dir;
+        trans_opt.profile_use_dir = params.codegen.profile_use_dir;
         trans_opt.panic_crate = params.codegen.panic_type == "" ? "panic_abort" : "panic_"+params.codegen.panic_type;
         for(const char* libdir : params.lib_search_dirs ) {
             // Store these paths for use in final linking.
@@ -769,6 +1047,7 @@ int main(int argc, char *argv[])
 
         // TODO: For 1.29 executables/dylibs, add oom/panic shims
 
+        const bool share_generics = params.debug.share_generics < 0 ? params.opt_level == 0 : params.debug.share_generics > 0;
         // Enumerate items to be passed to codegen
         TransList items = CompilePhase<TransList>("Trans Enumerate", [&]() {
             switch( crate_type )
@@ -780,12 +1059,12 @@ int main(int argc, char *argv[])
             case ::AST::Crate::Type::RustLib:
             case ::AST::Crate::Type::RustDylib:
             case ::AST::Crate::Type::CDylib:
-                return Trans_Enumerate_Public(*hir_crate);
+                return Trans_Enumerate_Public(*hir_crate, share_generics);
             case ::AST::Crate::Type::ProcMacro:
                 // TODO: proc macros enumerate twice, once as a library (why?) and again as an executable
-                return Trans_Enumerate_Public(*hir_crate);
+                return Trans_Enumerate_Public(*hir_crate, share_generics);
             case ::AST::Crate::Type::Executable:
-                return Trans_Enumerate_Main(*hir_crate);
+                return Trans_Enumerate_Main(*hir_crate, share_generics);
             }
             throw ::std::runtime_error("Invalid crate_type value");
             });
@@ -797,7 +1076,7 @@ int main(int argc, char *argv[])
         // - Generate monomorphised versions of all functions
         CompilePhaseV("Trans Monomorph", [&]() { Trans_Monomorphise_List(*hir_crate, items); });
         // - Do post-monomorph inlining
-        CompilePhaseV("MIR Optimise Inline", [&]() { MIR_OptimiseCrate_Inlining(*hir_crate, items); });
+        CompilePhaseV("MIR Optimise Inline", [&]() { MIR_OptimiseCrate_Inlining(*hir_crate, items, params.debug.num_threads); });
         // - Clean up no-unused functions
         CompilePhaseV("Trans Enumerate Cleanup", [&]() { Trans_Enumerate_Cleanup(*hir_crate, items); });
 
@@ -808,16 +1087,18 @@ int main(int argc, char *argv[])
         case ::AST::Crate::Type::Unknown:
             throw "";
         case ::AST::Crate::Type::RustLib:
+            Trans_Enumerate_RecordExports(*hir_crate, items);
             // Save a loadable HIR dump
-            CompilePhaseV("HIR Serialise", [&]() { HIR_Serialise(params.outfile + ".hir", *hir_crate); });
+            CompilePhaseV("HIR Serialise", [&]() { HIR_Serialise(params.outfile + ".hir", *hir_crate, params.debug.compress_hir); });
             // Generate a loadable .o
             CompilePhaseV("Trans Codegen", [&]() { Trans_Codegen(params.outfile, CodegenOutput::StaticLibrary, trans_opt, *hir_crate, items, params.outfile + ".hir"); });
             break;
         case ::AST::Crate::Type::RustDylib:
+            Trans_Enumerate_RecordExports(*hir_crate, items);
             // Save a loadable HIR dump
             CompilePhaseV("HIR Serialise", [&]() {
                 //auto saved_ext_crates = ::std::move(hir_crate->m_ext_crates);
-                HIR_Serialise(params.outfile + ".hir", *hir_crate);
+                HIR_Serialise(params.outfile + ".hir", *hir_crate, params.debug.compress_hir);
                 //hir_crate->m_ext_crates = ::std::move(saved_ext_crates);
                 });
             // Generate a .so
@@ -831,14 +1112,14 @@ int main(int argc, char *argv[])
             // Needs: An executable (the actual macro handler), metadata (for `extern crate foo;`)
 
             // 1. Generate code for the plugin itself
-            TransList items = CompilePhase<TransList>("Trans Enumerate PM", [&]() { return Trans_Enumerate_Main(*hir_crate); });
+            TransList items = CompilePhase<TransList>("Trans Enumerate PM", [&]() { return Trans_Enumerate_Main(*hir_crate, share_generics); });
             CompilePhaseV("Trans Auto Impls PM", [&]() { Trans_AutoImpls(*hir_crate, items); });
             CompilePhaseV("Trans Monomorph PM", [&]() { Trans_Monomorphise_List(*hir_crate, items); });
-            CompilePhaseV("MIR Optimise Inline PM", [&]() { MIR_OptimiseCrate_Inlining(*hir_crate, items); });
+            CompilePhaseV("MIR Optimise Inline PM", [&]() { MIR_OptimiseCrate_Inlining(*hir_crate, items, params.debug.num_threads); });
             // - Save a very basic HIR dump, making sure that there's no lang items in it (e.g. `mrustc-main`)
             CompilePhaseV("HIR Serialise", [&]() {
                 auto saved_lang_items = ::std::move(hir_crate->m_lang_items); hir_crate->m_lang_items.clear();
-                HIR_Serialise(params.outfile + ".hir", *hir_crate);
+                HIR_Serialise(params.outfile + ".hir", *hir_crate, params.debug.compress_hir);
                 hir_crate->m_lang_items = ::std::move(saved_lang_items);
                 });
             CompilePhaseV("Trans Codegen", [&]() { Trans_Codegen(params.outfile, CodegenOutput::Executable, trans_opt, *hir_crate, items, params.outfile + ".hir"); });
@@ -1010,6 +1291,57 @@ ProgramParams::ProgramParams(int argc, char *argv[])
                     get_optval();
                     this->codegen.panic_type = optval;
                 }
+                else if( optname == "codegen-units" ) {
+                    get_optval();
+                    char* end;
+                    auto v = ::std::strtoul(optval.c_str(), &end, 10);
+                    if( *end != '\0' || v == 0 ) {
+                        ::std::cerr << "Invalid value for -C codegen-units: '" << optval << "'" << ::std::endl;
+                        exit(1);
+                    }
+                    this->codegen.codegen_units = v;
+                }
+                else if( optname == "incremental" ) {
+                    get_optval();
+                    this->codegen.incremental_dir = optval;
+                }
+                else if( optname == "noalias" ) {
+                    if( eq_pos == ::std::string::npos || optval == "yes" )
+                        this->codegen.emit_noalias = true;
+                    else if( optval == "no" )
+                        this->codegen.emit_noalias = false;
+                    else {
+                        ::std::cerr << "Invalid value for -C noalias: '" << optval << "'" << ::std::endl;
+                        exit(1);
+                    }
+                }
+                else if( optname == "lto" ) {
+                    // NOTE: `thin` is accepted for rustc compatibility, but is the same as a full LTO
+                    if( eq_pos == ::std::string::npos || optval == "yes" || optval == "fat" || optval == "thin" )
+                        this->codegen.lto = true;
+                    else if( optval == "no" || optval == "off" )
+                        this->codegen.lto = false;
+                    else {
+                        ::std::cerr << "Invalid value for -C lto: '" << optval << "'" << ::std::endl;
+                        exit(1);
+                    }
+                }
+                else if( optname == "profile-generate" ) {
+                    get_optval();
+                    this->codegen.profile_generate_dir = optval;
+                    if( !this->codegen.profile_use_dir.empty() ) {
+                        ::std::cerr << "-C profile-generate and -C profile-use can't be used together" << ::std::endl;
+                        exit(1);
+                    }
+                }
+                else if( optname == "profile-use" ) {
+                    get_optval();
+                    this->codegen.profile_use_dir = optval;
+                    if( !this->codegen.profile_generate_dir.empty() ) {
+                        ::std::cerr << "-C profile-generate and -C profile-use can't be used together" << ::std::endl;
+                        exit(1);
+                    }
+                }
                 else {
                     ::std::cerr << "Unknown codegen option: '" << optname << "'" << ::std::endl;
                     exit(1);
@@ -1087,6 +1419,50 @@ ProgramParams::ProgramParams(int argc, char *argv[])
                         exit(1);
                     }
                 }
+                else if( optname == "threads" ) {
+                    get_optval();
+                    char* end;
+                    auto v = ::std::strtoul(optval.c_str(), &end, 10);
+                    if( *end != '\0' || v == 0 ) {
+                        ::std::cerr << "Invalid value for -Z threads: '" << optval << "'" << ::std::endl;
+                        exit(1);
+                    }
+                    this->debug.num_threads = v;
+                }
+                else if( optname == "typeck-stats" ) {
+                    // `-Z typeck-stats[=N]` - Report the N (default 20) bodies that took longest to typecheck
+                    this->debug.typeck_stats_count = 20;
+                    if( eq_pos != ::std::string::npos ) {
+                        char* end;
+                        auto v = ::std::strtoul(optval.c_str(), &end, 10);
+                        if( *end != '\0' || v == 0 ) {
+                            ::std::cerr << "Invalid value for -Z typeck-stats: '" << optval << "'" << ::std::endl;
+                            exit(1);
+                        }
+                        this->debug.typeck_stats_count = v;
+                    }
+                }
+                else if( optname == "share-generics" ) {
+                    if( eq_pos == ::std::string::npos || optval == "yes" )
+                        this->debug.share_generics = 1;
+                    else if( optval == "no" )
+                        this->debug.share_generics = 0;
+                    else {
+                        ::std::cerr << "Unknown argument to -Z share-generics - '" << optval << "'" << ::std::endl;
+                        exit(1);
+                    }
+                }
+                else if( optname == "hir-format" ) {
+                    get_optval();
+                    if( optval == "zlib" )
+                        this->debug.compress_hir = true;
+                    else if( optval == "raw" )
+                        this->debug.compress_hir = false;
+                    else {
+                        ::std::cerr << "Unknown argument to -Z hir-format - '" << optval << "'" << ::std::endl;
+                        exit(1);
+                    }
+                }
                 else if( optname == "print-cfgs") {
                     no_optval();
                     this->print_cfgs = true;
@@ -1264,6 +1640,16 @@ ProgramParams::ProgramParams(int argc, char *argv[])
             else if( strcmp(arg, "--test") == 0 ) {
                 this->test_harness = true;
             }
+            // `--timings=json` - Record per-phase timing and memory usage to `<outfile>.timings.json`
+            else if( const char* fmt = check_with_arg("timings") ) {
+                if( strcmp(fmt, "json") == 0 ) {
+                    this->emit_timings_json = true;
+                }
+                else {
+                    ::std::cerr << "Unknown value for --timings - '" << fmt << "'" << ::std::endl;
+                    exit(1);
+                }
+            }
             else if( const char* edition_str = check_with_arg("edition") ) {
                 if( strcmp(edition_str, "2015") == 0 ) {
                     this->edition = AST::Edition::Rust2015;
@@ -1343,6 +1729,7 @@ void ProgramParams::show_help() const
         "--cfg flag=\"val\"   : Set a string #[cfg]/cfg! flag\n"
         "--target <name>    : Compile code for the given target\n"
         "--test             : Generate a unit test executable\n"
+        "--timings=json     : Write per-phase timing and memory statistics to <output>.timings.json\n"
         "-C <option>        : Code-generation options\n"
         "-Z <option>        : Debugging/experimental options\n"
         ;
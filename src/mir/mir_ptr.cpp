@@ -7,13 +7,50 @@
  */
 #include "mir_ptr.hpp"
 #include "mir.hpp"
+#include <mutex>
 
+namespace {
+    // Shared by all deferred loads, they're rare enough that contention isn't a concern
+    ::std::mutex    s_materialise_lock;
+}
 
 void ::MIR::FunctionPointer::reset()
 {
-    if( this->ptr ) {
-        delete this->ptr;
-        this->ptr = nullptr;
+    if( auto* p = this->ptr.exchange(nullptr) ) {
+        delete p;
+    }
+    if( auto* l = this->m_loader.exchange(nullptr) ) {
+        delete l;
+    }
+}
+
+bool ::MIR::FunctionPointer::add_post_load(::std::function<void(::MIR::Function&)> cb)
+{
+    ::std::lock_guard<::std::mutex> _lh(s_materialise_lock);
+    auto* loader = this->m_loader.load();
+    if( !loader ) {
+        return false;
     }
+    loader->m_post_load.push_back(::std::move(cb));
+    return true;
 }
 
+::MIR::Function* ::MIR::FunctionPointer::materialise() const
+{
+    ::std::lock_guard<::std::mutex> _lh(s_materialise_lock);
+    // Check again, another thread may have loaded it while this one waited
+    if( auto* p = this->ptr.load() ) {
+        return p;
+    }
+    auto* loader = this->m_loader.load();
+    if( !loader ) {
+        return nullptr;
+    }
+    auto* rv = loader->load();
+    for(auto& cb : loader->m_post_load)
+        cb(*rv);
+    this->ptr = rv;
+    this->m_loader = nullptr;
+    delete loader;
+    return rv;
+}
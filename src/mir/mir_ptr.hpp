@@ -6,6 +6,9 @@
  * - Pointer to a blob of MIR
  */
 #pragma once
+#include <atomic>
+#include <functional>
+#include <vector>
 
 namespace MIR {
 
@@ -13,30 +16,65 @@ class Function;
 
 class FunctionPointer
 {
-    ::MIR::Function*    ptr;
 public:
-    FunctionPointer(): ptr(nullptr) {}
-    FunctionPointer(::MIR::Function* p): ptr(p) {}
-    FunctionPointer(FunctionPointer&& x): ptr(x.ptr) { x.ptr = nullptr; }
+    /// Deferred construction of the MIR (used for MIR loaded from crate metadata), run on first access
+    class Loader
+    {
+        friend class FunctionPointer;
+        /// Fixups to apply once loaded (e.g. binding paths, which is otherwise done when the crate is loaded)
+        ::std::vector<::std::function<void(::MIR::Function&)>>  m_post_load;
+    public:
+        virtual ~Loader() {}
+        virtual ::MIR::Function* load() = 0;
+    };
+private:
+    // NOTE: Atomic, as deferred MIR can be materialised from any of the optimisation worker threads
+    mutable ::std::atomic<::MIR::Function*> ptr;
+    mutable ::std::atomic<Loader*>  m_loader;
+
+    ::MIR::Function* get() const {
+        auto* rv = ptr.load();
+        if( !rv ) {
+            rv = materialise();
+            if( !rv )
+                throw "";
+        }
+        return rv;
+    }
+    ::MIR::Function* materialise() const;
+public:
+    FunctionPointer(): ptr(nullptr), m_loader(nullptr) {}
+    FunctionPointer(::MIR::Function* p): ptr(p), m_loader(nullptr) {}
+    FunctionPointer(FunctionPointer&& x): ptr(x.ptr.exchange(nullptr)), m_loader(x.m_loader.exchange(nullptr)) {}
+    static FunctionPointer new_deferred(Loader* loader) {
+        FunctionPointer rv;
+        rv.m_loader = loader;
+        return rv;
+    }
 
     ~FunctionPointer() {
         reset();
     }
     FunctionPointer& operator=(FunctionPointer&& x) {
         reset();
-        ptr = x.ptr;
-        x.ptr = nullptr;
+        ptr = x.ptr.exchange(nullptr);
+        m_loader = x.m_loader.exchange(nullptr);
         return *this;
     }
 
     void reset();
 
-          ::MIR::Function* operator->()       { if(!ptr) throw ""; return ptr; }
-    const ::MIR::Function* operator->() const { if(!ptr) throw ""; return ptr; }
-          ::MIR::Function& operator*()       { if(!ptr) throw ""; return *ptr; }
-    const ::MIR::Function& operator*() const { if(!ptr) throw ""; return *ptr; }
+    /// Queue an update to run when deferred MIR is loaded, returns false if the MIR isn't deferred (or has
+    /// already been loaded) and the update should be applied directly.
+    bool add_post_load(::std::function<void(::MIR::Function&)> cb);
+
+          ::MIR::Function* operator->()       { return get(); }
+    const ::MIR::Function* operator->() const { return get(); }
+          ::MIR::Function& operator*()       { return *get(); }
+    const ::MIR::Function& operator*() const { return *get(); }
 
-    operator bool() const { return ptr != nullptr; }
+    // NOTE: Doesn't materialise deferred MIR (checks the loader first, as it's cleared after `ptr` is set)
+    operator bool() const { return m_loader.load() != nullptr || ptr.load() != nullptr; }
 };
 
 }
@@ -14,8 +14,11 @@
 #include <mir/operations.hpp>
 #include <mir/visit_crate_mir.hpp>
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <iomanip>
+#include <set>
+#include <thread_pool.hpp>
 #include <trans/target.hpp>
 #include <trans/trans_list.hpp> // Note: This is included for inlining after enumeration and monomorph
 
@@ -59,7 +62,7 @@ enum {
     CHECKMODE_ALL,
 };
 static int check_mode() {
-    static int mode = CHECKMODE_UNKNOWN;
+    static ::std::atomic<int> mode { CHECKMODE_UNKNOWN };
     if( mode == CHECKMODE_UNKNOWN ) {
         const auto* n = getenv("MRUSTC_MIR_CHECK");
         if(n)
@@ -717,6 +720,11 @@ namespace
             if( it->second->monomorphised.code ) {
                 return &*it->second->monomorphised.code;
             }
+            else if( it->second->pp.has_types() ) {
+                // Generic instance linked from an upstream crate (see `-Z share-generics`), no code to inline
+                MIR_ASSERT(state, it->second->force_prototype, "Enumeration failure - Function had params, but wasn't monomorphised - " << path);
+                return nullptr;
+            }
             else if( const auto* mir = hir_fcn.m_code.get_mir_opt() ) {
                 MIR_ASSERT(state, hir_fcn.m_params.m_types.empty(), "Enumeration failure - Function had params, but wasn't monomorphised - " << path);
                 // TODO: Check for trait methods too?
@@ -769,6 +777,148 @@ namespace
         return nullptr;
     }
 
+    ::MIR::Statement clone_statement(const ::MIR::Statement& stmt)
+    {
+        TU_MATCH_HDRA( (stmt), {)
+        TU_ARMA(Assign, se) {
+            return ::MIR::Statement::make_Assign({ se.dst.clone(), se.src.clone() });
+            }
+        TU_ARMA(Asm, se) {
+            ::MIR::Statement::Data_Asm  rv;
+            rv.tpl = se.tpl;
+            for(const auto& e : se.outputs)
+                rv.outputs.push_back(::std::make_pair(e.first, e.second.clone()));
+            for(const auto& e : se.inputs)
+                rv.inputs.push_back(::std::make_pair(e.first, e.second.clone()));
+            rv.clobbers = se.clobbers;
+            rv.flags = se.flags;
+            return ::MIR::Statement(mv$(rv));
+            }
+        TU_ARMA(Asm2, se) {
+            ::std::vector<::MIR::AsmParam>  params;
+            for(const auto& p : se.params)
+            {
+                TU_MATCH_HDRA((p), {)
+                TU_ARMA(Const, v)
+                    params.push_back( v.clone() );
+                TU_ARMA(Sym, v)
+                    params.push_back( v.clone() );
+                TU_ARMA(Reg, v)
+                    params.push_back(::MIR::AsmParam::make_Reg({
+                        v.dir,
+                        v.spec.clone(),
+                        v.input  ? box$(v.input->clone()) : std::unique_ptr<MIR::Param>(),
+                        v.output ? box$(v.output->clone()) : std::unique_ptr<MIR::LValue>()
+                        }));
+                }
+            }
+            return ::MIR::Statement::make_Asm2({ se.options, se.lines, mv$(params) });
+            }
+        TU_ARMA(SetDropFlag, se) {
+            return ::MIR::Statement::make_SetDropFlag({ se.idx, se.new_val, se.other });
+            }
+        TU_ARMA(Drop, se) {
+            return ::MIR::Statement::make_Drop({ se.kind, se.slot.clone(), se.flag_idx });
+            }
+        TU_ARMA(ScopeEnd, se) {
+            return ::MIR::Statement::make_ScopeEnd({ se.slots });
+            }
+        }
+        throw "";
+    }
+    ::MIR::Terminator clone_terminator(const ::MIR::Terminator& term)
+    {
+        TU_MATCH_HDRA( (term), {)
+        TU_ARMA(Incomplete, te) {
+            return ::MIR::Terminator::make_Incomplete({});
+            }
+        TU_ARMA(Return, te) {
+            return ::MIR::Terminator::make_Return({});
+            }
+        TU_ARMA(Diverge, te) {
+            return ::MIR::Terminator::make_Diverge({});
+            }
+        TU_ARMA(Goto, te) {
+            return ::MIR::Terminator::make_Goto(te);
+            }
+        TU_ARMA(Panic, te) {
+            return ::MIR::Terminator::make_Panic({ te.dst });
+            }
+        TU_ARMA(If, te) {
+            return ::MIR::Terminator::make_If({ te.cond.clone(), te.bb0, te.bb1 });
+            }
+        TU_ARMA(Switch, te) {
+            return ::MIR::Terminator::make_Switch({ te.val.clone(), te.targets });
+            }
+        TU_ARMA(SwitchValue, te) {
+            return ::MIR::Terminator::make_SwitchValue({ te.val.clone(), te.def_target, te.targets, te.values.clone() });
+            }
+        TU_ARMA(Call, te) {
+            ::MIR::CallTarget   tgt;
+            TU_MATCH_HDRA( (te.fcn), {)
+            TU_ARMA(Value, ce)
+                tgt = ::MIR::CallTarget::make_Value( ce.clone() );
+            TU_ARMA(Path, ce)
+                tgt = ::MIR::CallTarget::make_Path( ce.clone() );
+            TU_ARMA(Intrinsic, ce)
+                tgt = ::MIR::CallTarget::make_Intrinsic({ ce.name, ce.params.clone() });
+            }
+            ::std::vector<::MIR::Param> args;
+            args.reserve(te.args.size());
+            for(const auto& a : te.args)
+                args.push_back( a.clone() );
+            return ::MIR::Terminator::make_Call({ te.ret_block, te.panic_block, te.ret_val.clone(), mv$(tgt), mv$(args) });
+            }
+        }
+        throw "";
+    }
+
+    /// Read-only copies of the MIR for functions that are being optimised on worker threads
+    ///
+    /// While optimising on multiple threads, a callee's live MIR may be in the middle of being rewritten by
+    /// another worker, so inlining reads the callee from this snapshot (taken before the workers start)
+    /// instead. Only functions small enough to pass `can_inline` are copied.
+    class InlineSnapshot
+    {
+        // `nullptr` for functions that are being optimised but are too large to ever be inlined
+        ::std::map<const ::MIR::Function*, ::std::unique_ptr<::MIR::Function>>  m_fcns;
+    public:
+        void add(const ::MIR::Function& fcn)
+        {
+            ::std::unique_ptr<::MIR::Function>  copy;
+            // NOTE: Must accept everything that `can_inline` might
+            if( fcn.blocks.size() <= 3 || fcn.blocks[0].terminator.is_Switch() || fcn.blocks[0].terminator.is_SwitchValue() )
+            {
+                copy.reset(new ::MIR::Function());
+                for(const auto& ty : fcn.locals)
+                    copy->locals.push_back( ty.clone() );
+                copy->drop_flags = fcn.drop_flags;
+                copy->blocks.reserve( fcn.blocks.size() );
+                for(const auto& bb : fcn.blocks)
+                {
+                    ::MIR::BasicBlock   new_bb;
+                    new_bb.statements.reserve( bb.statements.size() );
+                    for(const auto& stmt : bb.statements)
+                        new_bb.statements.push_back( clone_statement(stmt) );
+                    new_bb.terminator = clone_terminator(bb.terminator);
+                    copy->blocks.push_back( mv$(new_bb) );
+                }
+            }
+            m_fcns.insert(::std::make_pair( &fcn, mv$(copy) ));
+        }
+        /// Returns the MIR that inlining can inspect for `fcn`, or `nullptr` if it shouldn't be inlined
+        const ::MIR::Function* get(const ::MIR::Function* fcn) const
+        {
+            auto it = m_fcns.find(fcn);
+            // Not being optimised (e.g. from an external crate), so the live copy is stable
+            if( it == m_fcns.end() )
+                return fcn;
+            return it->second.get();
+        }
+    };
+    /// Set while a worker thread is running optimisations (see `MIR_OptimiseCrate`)
+    thread_local const InlineSnapshot*  tls_inline_snapshot;
+
 
     void visit_terminator_target_mut(::MIR::Terminator& term, ::std::function<void(::MIR::BasicBlockId&)> cb) {
         TU_MATCH_HDRA( (term), {)
@@ -1716,6 +1866,15 @@ bool MIR_Optimise_Inlining(::MIR::TypeResolve& state, ::MIR::Function& fcn, bool
                 DEBUG("Can't inline - recursion");
                 continue ;
             }
+            if( tls_inline_snapshot )
+            {
+                called_mir = tls_inline_snapshot->get(called_mir);
+                if( !called_mir )
+                {
+                    DEBUG("Can't inline " << path << " - too large (not in snapshot)");
+                    continue ;
+                }
+            }
 
             // Check the size of the target function.
             // Inline IF:
@@ -6060,29 +6219,154 @@ void MIR_SortBlocks(const StaticTraitResolve& resolve, const ::HIR::ItemPath& pa
 }
 
 
-void MIR_OptimiseCrate(::HIR::Crate& crate, bool do_minimal_optimisation)
+namespace {
+    /// Sets the worker's inlining snapshot for the duration of a job
+    struct InlineSnapshotGuard
+    {
+        InlineSnapshotGuard(const InlineSnapshot& s) { tls_inline_snapshot = &s; }
+        ~InlineSnapshotGuard() { tls_inline_snapshot = nullptr; }
+    };
+    /// One resolver per worker, as `StaticTraitResolve` caches results internally
+    ::std::vector<::std::unique_ptr<StaticTraitResolve>> make_worker_resolves(const ::HIR::Crate& crate, unsigned num_threads)
+    {
+        ::std::vector<::std::unique_ptr<StaticTraitResolve>>    rv;
+        for(unsigned i = 0; i < num_threads; i ++)
+            rv.push_back(::std::unique_ptr<StaticTraitResolve>(new StaticTraitResolve(crate)));
+        return rv;
+    }
+}
+
+void MIR_OptimiseCrate(::HIR::Crate& crate, bool do_minimal_optimisation, unsigned num_threads)
 {
-    ::MIR::OuterVisitor ov { crate, [do_minimal_optimisation](const auto& res, const auto& p, auto& expr, const auto& args, const auto& ty)
-        {
-            //if( ! dynamic_cast<::HIR::ExprNode_Block*>(expr.get()) ) {
-            //    return ;
-            //}
-            auto& mir = expr.get_mir_or_error_mut(Span());
-            if( do_minimal_optimisation ) {
-                MIR_OptimiseMin(res, p, mir, args, ty);
-            }
-            else {
-                MIR_Optimise(res, p, mir, args, ty);
+    if( num_threads <= 1 )
+    {
+        ::MIR::OuterVisitor ov { crate, [do_minimal_optimisation](const auto& res, const auto& p, auto& expr, const auto& args, const auto& ty)
+            {
+                //if( ! dynamic_cast<::HIR::ExprNode_Block*>(expr.get()) ) {
+                //    return ;
+                //}
+                auto& mir = expr.get_mir_or_error_mut(Span());
+                if( do_minimal_optimisation ) {
+                    MIR_OptimiseMin(res, p, mir, args, ty);
+                }
+                else {
+                    MIR_Optimise(res, p, mir, args, ty);
+                }
             }
+            };
+        ov.visit_crate(crate);
+        return ;
+    }
+
+    // Collect every body (and the generics that were in scope for it), then optimise them on the worker pool
+    struct Job {
+        ::std::string   path;
+        ::MIR::Function*    mir;
+        const ::HIR::Function::args_t*  args;
+        ::HIR::TypeRef  ret_ty;
+        const ::HIR::GenericParams* impl_generics;
+        const ::HIR::GenericParams* item_generics;
+    };
+    const ::HIR::Function::args_t   no_args;
+    ::std::vector<Job>  jobs;
+    ::MIR::OuterVisitor ov { crate, [&](const auto& res, const auto& p, auto& expr, const auto& args, const auto& ty)
+        {
+            // NOTE: `args` is a temporary when empty (statics/constants), and `ty` can be a temporary
+            jobs.push_back(Job { FMT(p), &expr.get_mir_or_error_mut(Span()), args.empty() ? &no_args : &args, ty.clone(), res.m_impl_generics, res.m_item_generics });
         }
         };
     ov.visit_crate(crate);
+    DEBUG(jobs.size() << " bodies on " << num_threads << " threads");
+
+    auto resolves = make_worker_resolves(crate, num_threads);
+    auto run_jobs = [&](const InlineSnapshot& snapshot, ::std::function<void(const StaticTraitResolve&, const ::HIR::ItemPath&, const Job&)> cb) {
+        ThreadPool::run(num_threads, jobs.size(), [&](unsigned worker_idx, size_t job_idx) {
+            const auto& job = jobs[job_idx];
+            auto& resolve = *resolves[worker_idx];
+            InlineSnapshotGuard _sg(snapshot);
+            resolve.set_both_generics_raw(job.impl_generics, job.item_generics);
+            cb(resolve, ::HIR::ItemPath(job.path), job);
+            resolve.clear_both_generics();
+            });
+        };
+
+    InlineSnapshot  empty_snapshot;
+    if( do_minimal_optimisation )
+    {
+        // Minimal mode doesn't inline, so there's no cross-function access
+        run_jobs(empty_snapshot, [](const StaticTraitResolve& resolve, const ::HIR::ItemPath& ip, const Job& job) {
+            MIR_OptimiseMin(resolve, ip, *job.mir, *job.args, job.ret_ty);
+            });
+    }
+    else
+    {
+        // Optimise without inlining first, so the snapshot holds already-simplified callees (as the serial
+        // visit order would usually see them), then run the full optimisation with inlining from that snapshot.
+        // - Functions are only inlined from the snapshot, never from the live MIR of another worker's function.
+        run_jobs(empty_snapshot, [](const StaticTraitResolve& resolve, const ::HIR::ItemPath& ip, const Job& job) {
+            MIR_Optimise(resolve, ip, *job.mir, *job.args, job.ret_ty, /*do_inline=*/false);
+            });
+        InlineSnapshot  snapshot;
+        for(const auto& job : jobs)
+            snapshot.add(*job.mir);
+        run_jobs(snapshot, [](const StaticTraitResolve& resolve, const ::HIR::ItemPath& ip, const Job& job) {
+            MIR_Optimise(resolve, ip, *job.mir, *job.args, job.ret_ty);
+            });
+    }
 }
 
-void MIR_OptimiseCrate_Inlining(const ::HIR::Crate& crate, TransList& list)
+void MIR_OptimiseCrate_Inlining(const ::HIR::Crate& crate, TransList& list, unsigned num_threads)
 {
     ::StaticTraitResolve    resolve { crate };
 
+    // Optimises a single function, returns true if inlining happened
+    auto optimise_fcn = [&list](const StaticTraitResolve& resolve, const ::HIR::Path& path, TransList_Function& fcn_ent)->bool {
+        //const auto& pp = fcn_ent.pp;
+        auto& hir_fcn = *const_cast<::HIR::Function*>(fcn_ent.ptr);
+        auto& mono_fcn = fcn_ent.monomorphised;
+
+        ::std::string s = FMT(path);
+        ::HIR::ItemPath ip(s);
+
+        bool did_opt = false;
+        if( mono_fcn.code )
+        {
+            did_opt = MIR_OptimiseInline(resolve, ip, *mono_fcn.code, mono_fcn.arg_tys, mono_fcn.ret_ty, list);
+
+            MIR_Cleanup(resolve, ip, *mono_fcn.code, mono_fcn.arg_tys, mono_fcn.ret_ty);
+        }
+        else if( hir_fcn.m_code )
+        {
+            auto& mir = hir_fcn.m_code.get_mir_or_error_mut(Span());
+            did_opt = MIR_OptimiseInline(resolve, ip, mir, hir_fcn.m_args, hir_fcn.m_return, list);
+            mir.trans_enum_state = ::MIR::EnumCachePtr();   // Clear MIR enum cache
+
+            MIR_Cleanup(resolve, ip, mir, hir_fcn.m_args, hir_fcn.m_return);
+        }
+        else
+        {
+            // Extern, no optimisations
+        }
+        return did_opt;
+        };
+
+    // For threaded mode: the functions that will be modified (each MIR body once)
+    ::std::vector< ::std::pair<const ::HIR::Path*, TransList_Function*> >  jobs;
+    ::std::vector<::std::unique_ptr<StaticTraitResolve>>    resolves;
+    if( num_threads > 1 )
+    {
+        ::std::set<const ::MIR::Function*>  seen;
+        for(auto& fcn_ent : list.m_functions)
+        {
+            const ::MIR::Function* mir = fcn_ent.second->monomorphised.code ? &*fcn_ent.second->monomorphised.code
+                : fcn_ent.second->ptr->m_code ? fcn_ent.second->ptr->m_code.get_mir_opt()
+                : nullptr;
+            if( mir && seen.insert(mir).second )
+                jobs.push_back(::std::make_pair( &fcn_ent.first, fcn_ent.second.get() ));
+        }
+        resolves = make_worker_resolves(crate, num_threads);
+    }
+
     bool did_inline_on_pass;
 
     size_t  MAX_ITERATIONS = 5; // TODO: Tune this.
@@ -6091,34 +6375,28 @@ void MIR_OptimiseCrate_Inlining(const ::HIR::Crate& crate, TransList& list)
     {
         did_inline_on_pass = false;
 
-        for(auto& fcn_ent : list.m_functions)
+        if( num_threads > 1 )
         {
-            const auto& path = fcn_ent.first;
-            //const auto& pp = fcn_ent.second->pp;
-            auto& hir_fcn = *const_cast<::HIR::Function*>(fcn_ent.second->ptr);
-            auto& mono_fcn = fcn_ent.second->monomorphised;
-
-            ::std::string s = FMT(path);
-            ::HIR::ItemPath ip(s);
-
-            if( mono_fcn.code )
-            {
-                did_inline_on_pass |= MIR_OptimiseInline(resolve, ip, *mono_fcn.code, mono_fcn.arg_tys, mono_fcn.ret_ty, list);
-
-                MIR_Cleanup(resolve, ip, *mono_fcn.code, mono_fcn.arg_tys, mono_fcn.ret_ty);
-            }
-            else if( hir_fcn.m_code )
-            {
-                auto& mir = hir_fcn.m_code.get_mir_or_error_mut(Span());
-                bool did_opt = MIR_OptimiseInline(resolve, ip, mir, hir_fcn.m_args, hir_fcn.m_return, list);
-                mir.trans_enum_state = ::MIR::EnumCachePtr();   // Clear MIR enum cache
-                did_inline_on_pass |= did_opt;
-
-                MIR_Cleanup(resolve, ip, mir, hir_fcn.m_args, hir_fcn.m_return);
-            }
-            else
+            // Callees are read from a snapshot taken at the start of each pass
+            InlineSnapshot  snapshot;
+            for(const auto& j : jobs)
+            {
+                const auto& fcn_ent = *j.second;
+                snapshot.add(fcn_ent.monomorphised.code ? *fcn_ent.monomorphised.code : *fcn_ent.ptr->m_code.get_mir_opt());
+            }
+            ::std::atomic<bool> any_inlined { false };
+            ThreadPool::run(num_threads, jobs.size(), [&](unsigned worker_idx, size_t job_idx) {
+                InlineSnapshotGuard _sg(snapshot);
+                if( optimise_fcn(*resolves[worker_idx], *jobs[job_idx].first, *jobs[job_idx].second) )
+                    any_inlined = true;
+                });
+            did_inline_on_pass = any_inlined;
+        }
+        else
+        {
+            for(auto& fcn_ent : list.m_functions)
             {
-                // Extern, no optimisations
+                did_inline_on_pass |= optimise_fcn(resolve, fcn_ent.first, *fcn_ent.second);
             }
         }
     } while( did_inline_on_pass && num_iterations < MAX_ITERATIONS );
@@ -16,6 +16,7 @@
 #include <algorithm>    // std::count
 #include <limits>       // std::numeric_limits
 #include <cctype>
+#include <iterator>     // std::istreambuf_iterator
 //#define TRACE_CHARS
 //#define TRACE_RAW_TOKENS
 
@@ -24,33 +25,51 @@ Lexer::Lexer(const ::std::string& filename, AST::Edition edition, ParseState ps)
     m_path(filename.c_str()),
     m_line(1),
     m_line_ofs(0),
-    m_istream_fp(filename != "-" ? new std::ifstream(filename.c_str()) : nullptr),
-    m_istream(filename != "-" ? *m_istream_fp : std::cin),
+    m_cursor(nullptr),
+    m_end(nullptr),
     m_last_char_valid(false),
     m_edition(edition),
     m_hygiene( Ident::Hygiene::new_scope() )
 {
-    if( m_istream_fp )
+    // Read the entire file up-front, so scanning is just pointer walking
+    if( filename != "-" )
     {
-        if( !m_istream_fp->is_open() )
+        ::std::ifstream is(filename, ::std::ios::binary);
+        if( !is.is_open() )
         {
             throw ::std::runtime_error("Unable to open file '" + filename + "'");
         }
+        is.seekg(0, ::std::ios::end);
+        auto len = is.tellg();
+        is.seekg(0, ::std::ios::beg);
+        if( len > 0 )
+        {
+            m_source.resize(static_cast<size_t>(len));
+            is.read(&m_source[0], len);
+            m_source.resize(static_cast<size_t>(is.gcount()));
+        }
+    }
+    else
+    {
+        m_source.assign(::std::istreambuf_iterator<char>(::std::cin), ::std::istreambuf_iterator<char>());
+    }
+    m_cursor = m_source.data();
+    m_end = m_source.data() + m_source.size();
+
+    if( filename != "-" )
+    {
         // Consume the BOM
-        if( this->getc_byte() == '\xef' )
+        if( m_cursor != m_end && *m_cursor == '\xef' )
         {
-            if( this->getc_byte() != '\xbb' ) {
+            m_cursor ++;
+            if( m_cursor == m_end || *m_cursor++ != '\xbb' ) {
                 throw ::std::runtime_error("Incomplete BOM - missing \\xBB in second position");
             }
-            if( this->getc_byte() != '\xbf' ) {
+            if( m_cursor == m_end || *m_cursor++ != '\xbf' ) {
                 throw ::std::runtime_error("Incomplete BOM - missing \\xBF in second position");
             }
             m_line_ofs = 0;
         }
-        else
-        {
-            m_istream.unget();
-        }
     }
 }
 
@@ -373,6 +392,7 @@ Token Lexer::getTokenInt()
             return Token(TOK_NEWLINE);
         if( ch.isspace() )
         {
+            this->getc_ascii_run([](char c){ return c == ' ' || c == '\t'; }, nullptr);
             while( (ch = this->getc()).isspace() && ch != '\n' )
                 ;
             this->ungetc();
@@ -663,6 +683,7 @@ Token Lexer::getTokenInt()
                 while(ch != '\n' && ch != '\r')
                 {
                     str += ch;
+                    this->getc_ascii_run([](char c){ return c != '\n' && c != '\r'; }, &str);
                     ch = this->getc();
                 }
                 this->ungetc();
@@ -725,6 +746,7 @@ Token Lexer::getTokenInt()
                         }
                         else {
                             str += ch;
+                            this->getc_ascii_run([](char c){ return c != '/' && c != '*' && c != '\n' && c != '\r'; }, &str);
                         }
                     }
                     ch = this->getc();
@@ -891,6 +913,7 @@ Token Lexer::getTokenInt_Identifier(Codepoint leader, Codepoint leader2, bool pa
     while( issym(ch) )
     {
         str += ch;
+        this->getc_ascii_run([](char c){ return ('0' <= c && c <= '9') || ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || c == '_'; }, &str);
         ch = this->getc();
     }
 
@@ -1037,18 +1060,15 @@ uint32_t Lexer::parseEscape(char enclosing)
 
 char Lexer::getc_byte()
 {
-    int rv = m_istream.get();
-    if( rv == EOF || m_istream.eof() )
+    if( m_cursor == m_end )
         throw Lexer::EndOfFile();
 
+    char rv = *m_cursor++;
     if( rv == '\r' )
     {
-        if( m_istream.get() != '\n' )
-        {
-            m_istream.unget();
-        }
-        else
+        if( m_cursor != m_end && *m_cursor == '\n' )
         {
+            m_cursor ++;
             rv = '\n';
         }
     }
@@ -1060,6 +1080,25 @@ char Lexer::getc_byte()
 
     return rv;
 }
+/// Fast path for long runs (whitespace, comments, identifiers): consume ASCII characters matching
+/// `pred` directly from the buffer, appending them to `out` (if non-null).
+///
+/// Stops at the first non-ASCII or non-matching byte, which is left for `getc`. `pred` must not
+/// accept `\r` or `\n` (line tracking is handled by `getc_byte`).
+template<typename Pred>
+void Lexer::getc_ascii_run(Pred pred, ::std::string* out)
+{
+    // A pushed-back character must be returned by `getc` first
+    if( m_last_char_valid )
+        return ;
+    const char* start = m_cursor;
+    while( m_cursor != m_end && static_cast<uint8_t>(*m_cursor) < 128 && pred(*m_cursor) )
+        m_cursor ++;
+    size_t len = m_cursor - start;
+    m_line_ofs += len;
+    if( out )
+        out->append(start, len);
+}
 Codepoint Lexer::getc()
 {
     if( m_last_char_valid )
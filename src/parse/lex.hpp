@@ -39,8 +39,10 @@ class Lexer:
     unsigned int m_line;
     unsigned int m_line_ofs;
 
-    ::std::unique_ptr<::std::ifstream>  m_istream_fp;
-    ::std::istream& m_istream;
+    /// Entire source file, scanned through `m_cursor`
+    ::std::string   m_source;
+    const char* m_cursor;
+    const char* m_end;
     bool    m_last_char_valid;
     Codepoint   m_last_char;
     ::std::vector<Token>    m_next_tokens;
@@ -78,6 +80,8 @@ private:
     Codepoint getc();
     Codepoint getc_cp();
     char getc_byte();
+    template<typename Pred>
+    void getc_ascii_run(Pred pred, ::std::string* out);
 
     class EndOfFile {};
 };
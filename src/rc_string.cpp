@@ -10,6 +10,8 @@
 #include <string>
 #include <iostream>
 #include <algorithm>    // std::max
+#include <mutex>
+#include <vector>
 
 RcString::RcString(const char* s, size_t len):
     m_ptr(nullptr)
@@ -18,9 +20,12 @@ RcString::RcString(const char* s, size_t len):
     {
         size_t nwords = (len+1 + sizeof(unsigned int)-1) / sizeof(unsigned int);
         m_ptr = reinterpret_cast<Inner*>(malloc(sizeof(Inner) + (nwords - 1) * sizeof(unsigned int)));
-        m_ptr->refcount = 1;
+        // - Allocated with malloc, so the atomics need to be explicitly constructed
+        new (&m_ptr->refcount) ::std::atomic<unsigned int>(1);
         m_ptr->size = static_cast<unsigned>(len);
-        m_ptr->ordering = 0;
+        m_ptr->symbol_id = 0;
+        m_ptr->hash = 0;
+        m_ptr->ord_prefix = 0;
         char* data_mut = reinterpret_cast<char*>(m_ptr->data);
         for(unsigned int j = 0; j < len; j ++ )
             data_mut[j] = s[j];
@@ -33,9 +38,8 @@ RcString::~RcString()
 {
     if(m_ptr)
     {
-        m_ptr->refcount -= 1;
         //::std::cout << "RcString(" << m_ptr << " \"" << *this << "\") - " << *m_ptr << " refs left (drop)" << ::std::endl;
-        if( m_ptr->refcount == 0 )
+        if( --m_ptr->refcount == 0 )
         {
             free(m_ptr);
         }
@@ -83,49 +87,120 @@ Ordering RcString::ord(const char* s) const
 }
 
 
-struct Cmp_RcString_Raw {
-    bool operator()(const RcString& a, const RcString& b) const {
-        return a.ord(b.c_str(), b.size()) == OrdLess;
+namespace {
+    // http://www.cse.yorku.ca/~oz/hash.html "djb2"
+    size_t hash_string_bytes(const char* s, size_t len)
+    {
+        size_t h = 5381;
+        for(size_t i = 0; i < len; i ++) {
+            h = h * 33 + (unsigned)s[i];
+        }
+        return h;
     }
-};
-// A set with a comparison function that always checks bytes (avoiding recursion with the cache)
-::std::set<RcString,Cmp_RcString_Raw>    RcString_interned_strings;
-bool    RcString_interned_ordering_valid;
+
+    /// Interned string table, split into shards (each with its own lock) so threads interning different strings
+    /// rarely contend.
+    ///
+    /// Each shard is an open-addressed (linear probing) hash table of interned strings, which are never removed.
+    class Interner
+    {
+        static const unsigned SHARD_BITS = 6;
+        struct Shard
+        {
+            ::std::mutex    lock;
+            ::std::vector<RcString> slots;  // Power of two sized, empty strings are unused slots
+            size_t  count = 0;
+        };
+        Shard   m_shards[1 << SHARD_BITS];
+        ::std::atomic<unsigned int> m_next_id { 1 };
+
+    public:
+        template<typename Fcn>
+        RcString intern(const char* s, size_t len, Fcn init)
+        {
+            size_t h = hash_string_bytes(s, len);
+            // Shard on the top bits (after mixing) and probe using the low bits, so they're independent
+            auto& shard = m_shards[(static_cast<uint64_t>(h) * 0x9E3779B97F4A7C15ull) >> (64 - SHARD_BITS)];
+            ::std::lock_guard<::std::mutex> _lh(shard.lock);
+
+            if( (shard.count + 1) * 4 > shard.slots.size() * 3 )
+                grow(shard);
+            size_t mask = shard.slots.size() - 1;
+            for(size_t i = h & mask; ; i = (i + 1) & mask)
+            {
+                auto& slot = shard.slots[i];
+                if( slot.size() == 0 )
+                {
+                    slot = RcString(s, len);
+                    init(slot, h, m_next_id++);
+                    shard.count += 1;
+                    return slot;
+                }
+                if( get_hash(slot) == h && slot.ord(s, len) == OrdEqual )
+                {
+                    return slot;
+                }
+            }
+        }
+    private:
+        static size_t get_hash(const RcString& s) {
+            return ::std::hash<RcString>()(s);
+        }
+        static void grow(Shard& shard)
+        {
+            auto old_slots = ::std::move(shard.slots);
+            shard.slots = ::std::vector<RcString>(old_slots.empty() ? 64 : old_slots.size() * 2);
+            size_t mask = shard.slots.size() - 1;
+            for(auto& e : old_slots)
+            {
+                if( e.size() == 0 )
+                    continue;
+                size_t i = get_hash(e) & mask;
+                while( shard.slots[i].size() != 0 )
+                    i = (i + 1) & mask;
+                shard.slots[i] = ::std::move(e);
+            }
+        }
+    };
+    // Never destroyed, so interned strings stay valid during exit
+    Interner& get_interner() {
+        static Interner* rv = new Interner();
+        return *rv;
+    }
+}
 
 RcString RcString::new_interned(const char* s, size_t len)
 {
     if(len == 0)
         return RcString();
-    auto ret = RcString_interned_strings.insert(RcString(s, len));
-    // Set interned and invalidate the cache if an insert happened
-    if(ret.second)
-    {
-        ret.first->m_ptr->ordering = 1;
-        RcString_interned_ordering_valid = false;
-    }
-    return *ret.first;
+    return get_interner().intern(s, len, [](RcString& rv, size_t hash, unsigned int id) {
+        auto* inner = rv.m_ptr;
+        inner->hash = hash;
+        // Big-endian, so an integer compare matches `memcmp` (zero padding sorts shorter strings first, and
+        // any equal prefixes are resolved by a full compare)
+        uint64_t prefix = 0;
+        const char* data = rv.c_str();
+        for(size_t i = 0; i < 8; i ++)
+            prefix = (prefix << 8) | (i < rv.size() ? static_cast<uint8_t>(data[i]) : 0);
+        inner->ord_prefix = prefix;
+        inner->symbol_id = id;
+        });
 }
-Ordering RcString::ord_interned(const RcString& s) const
+::std::vector<RcString> RcString::new_interned_bulk(const ::std::vector<::std::pair<const char*,size_t>>& strings)
 {
-    assert(s.is_interned() && this->is_interned());
-    if(!RcString_interned_ordering_valid)
+    ::std::vector<RcString> rv;
+    rv.reserve(strings.size());
+    for(const auto& e : strings)
     {
-        // Populate cache
-        unsigned i = 1;
-        for(auto& e : RcString_interned_strings)
-            e.m_ptr->ordering = i++;
-        RcString_interned_ordering_valid = true;
+        rv.push_back(new_interned(e.first, e.second));
     }
-    return ::ord(this->m_ptr->ordering, s.m_ptr->ordering);
+    return rv;
 }
 
 size_t std::hash<RcString>::operator()(const RcString& s) const noexcept
 {
-    // http://www.cse.yorku.ca/~oz/hash.html "djb2"
-    size_t h = 5381;
-    for(auto c : s) {
-        h = h * 33 + (unsigned)c;
-    }
-    return h;
+    if( s.is_interned() )
+        return s.m_ptr->hash;
+    return hash_string_bytes(s.c_str(), s.size());
     //return hash<std::string_view>(s.c_str(), s.size());
 }
@@ -10,34 +10,129 @@
 #include <span.hpp>
 #include <parse/lex.hpp>
 #include <common.hpp>
+#include <mutex>
+#include <vector>
 
-SpanInner Span::s_empty_span;
+namespace {
+    const size_t CHUNK_SIZE = 1 << 16;
 
-Span::Span(Span parent, RcString filename, unsigned int start_line, unsigned int start_ofs,  unsigned int end_line, unsigned int end_ofs):
-    m_ptr(SpanInner::alloc( parent, ::std::move(filename), start_line, start_ofs, end_line, end_ofs ))
-{}
-Span::Span(Span parent, const Position& pos):
-    m_ptr(SpanInner::alloc( parent, pos.filename, pos.line,pos.ofs, pos.line,pos.ofs ))
-{
-}
-Span::Span(const Span& x):
-    m_ptr(x.m_ptr)
-{
-    m_ptr->reference_count += 1;
+    /// De-duplication table for the source map, split into shards (each with its own lock)
+    ///
+    /// Each shard is an open-addressed (linear probing) hash table of source map indexes, zero for unused slots.
+    struct SourceMapShard
+    {
+        ::std::mutex    lock;
+        ::std::vector<uint32_t> slots;
+        size_t  count = 0;
+    };
+    const unsigned SHARD_BITS = 4;
+    SourceMapShard* get_shards() {
+        // Never destroyed (spans may be created during exit)
+        static SourceMapShard* rv = new SourceMapShard[1 << SHARD_BITS];
+        return rv;
+    }
+    ::std::mutex    s_chunk_lock;
+    ::std::atomic<uint32_t> s_next_idx { 1 };
+
+    // NOTE: Hashes the filename by identity (spans from a file all share the lexer's string). A different string with
+    // the same content only results in a duplicate entry.
+    uint64_t hash_span(uint32_t parent, const char* filename, unsigned int start_line, unsigned int start_ofs,  unsigned int end_line, unsigned int end_ofs)
+    {
+        uint64_t h = parent;
+        for(uint64_t v : { static_cast<uint64_t>(reinterpret_cast<uintptr_t>(filename)), uint64_t(start_line), uint64_t(start_ofs), uint64_t(end_line), uint64_t(end_ofs) })
+            h = (h ^ v) * 0x9E3779B97F4A7C15ull;
+        return h ^ (h >> 29);
+    }
 }
-Span::~Span()
+// The first chunk is static (and constant-initialised), so the empty span (index 0) is always valid
+// - Wrapped in a union so it's never destroyed, like the other chunks
+static union FirstChunk {
+    SpanInner   entries[CHUNK_SIZE];
+    constexpr FirstChunk(): entries() {}
+    ~FirstChunk() {}
+} s_first_chunk;
+::std::atomic<SpanInner*>   Span::s_chunks[1 << (32 - CHUNK_BITS)] = { {s_first_chunk.entries} };
+
+uint32_t Span::add(Span parent, RcString filename, unsigned int start_line, unsigned int start_ofs,  unsigned int end_line, unsigned int end_ofs)
 {
-    if(m_ptr && m_ptr != &s_empty_span)
+    static_assert(CHUNK_SIZE == 1 << CHUNK_BITS, "CHUNK_SIZE mismatch");
+    auto hash_entry = [](uint32_t idx) {
+        const auto& e = get(idx);
+        return hash_span(e.parent_span.m_idx, e.filename.c_str(), e.start_line, e.start_ofs, e.end_line, e.end_ofs);
+        };
+    auto h = hash_span(parent.m_idx, filename.c_str(), start_line, start_ofs, end_line, end_ofs);
+    auto& shard = get_shards()[h >> (64 - SHARD_BITS)];
+    ::std::lock_guard<::std::mutex> _lh(shard.lock);
+
+    if( (shard.count + 1) * 4 > shard.slots.size() * 3 )
+    {
+        auto old_slots = ::std::move(shard.slots);
+        shard.slots = ::std::vector<uint32_t>(old_slots.empty() ? 1024 : old_slots.size() * 2);
+        size_t mask = shard.slots.size() - 1;
+        for(auto idx : old_slots)
+        {
+            if( idx == 0 )
+                continue ;
+            size_t i = hash_entry(idx) & mask;
+            while( shard.slots[i] != 0 )
+                i = (i + 1) & mask;
+            shard.slots[i] = idx;
+        }
+    }
+
+    size_t mask = shard.slots.size() - 1;
+    for(size_t i = h & mask; ; i = (i + 1) & mask)
     {
-        m_ptr->reference_count --;
-        if( m_ptr->reference_count == 0 )
+        auto idx = shard.slots[i];
+        if( idx == 0 )
         {
-            delete m_ptr;
+            // New entry, allocate from the (shared) source map
+            idx = s_next_idx++;
+            if( idx == 0 )
+            {
+                ::std::cerr << "BUG: Source map full" << ::std::endl;
+                abort();
+            }
+            auto& chunk = s_chunks[idx >> CHUNK_BITS];
+            if( !chunk.load(::std::memory_order_acquire) )
+            {
+                ::std::lock_guard<::std::mutex> _lh(s_chunk_lock);
+                if( !chunk.load(::std::memory_order_acquire) )
+                    chunk.store(new SpanInner[CHUNK_SIZE], ::std::memory_order_release);
+            }
+            auto& e = chunk.load(::std::memory_order_acquire)[idx & (CHUNK_SIZE - 1)];
+            e.parent_span = parent;
+            e.filename = ::std::move(filename);
+            e.start_line = start_line;
+            e.start_ofs = start_ofs;
+            e.end_line = end_line;
+            e.end_ofs = end_ofs;
+
+            shard.slots[i] = idx;
+            shard.count += 1;
+            return idx;
+        }
+        const auto& e = get(idx);
+        if( e.parent_span == parent && e.filename.c_str() == filename.c_str()
+            && e.start_line == start_line && e.start_ofs == start_ofs && e.end_line == end_line && e.end_ofs == end_ofs )
+        {
+            return idx;
         }
-        m_ptr = nullptr;
     }
 }
 
+Span::Span(Span parent, RcString filename, unsigned int start_line, unsigned int start_ofs,  unsigned int end_line, unsigned int end_ofs):
+    m_idx(add( parent, ::std::move(filename), start_line, start_ofs, end_line, end_ofs ))
+{}
+Span::Span(Span parent, const Position& pos):
+    m_idx(add( parent, pos.filename, pos.line,pos.ofs, pos.line,pos.ofs ))
+{
+}
+size_t Span::source_map_size()
+{
+    return s_next_idx.load() - 1;
+}
+
 namespace {
     void print_span_message(const Span& sp, ::std::function<void(::std::ostream&)> tag, ::std::function<void(::std::ostream&)> msg)
     {
@@ -0,0 +1,108 @@
+/*
+ * MRustC - Rust Compiler
+ * - By John Hodge (Mutabah/thePowersGang)
+ *
+ * thread_pool.cpp
+ * - Work-stealing pool for running independent jobs in parallel
+ */
+#include <thread_pool.hpp>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct WorkerQueue
+    {
+        ::std::mutex    lock;
+        ::std::deque<size_t>    jobs;
+
+        // The owning worker takes from the front (so jobs run roughly in submission order)
+        bool pop_own(size_t& out) {
+            ::std::lock_guard<::std::mutex> _lh(lock);
+            if( jobs.empty() )
+                return false;
+            out = jobs.front();
+            jobs.pop_front();
+            return true;
+        }
+        // Other workers steal from the back (furthest from what the owner is working on)
+        bool steal(size_t& out) {
+            ::std::lock_guard<::std::mutex> _lh(lock);
+            if( jobs.empty() )
+                return false;
+            out = jobs.back();
+            jobs.pop_back();
+            return true;
+        }
+    };
+}
+
+void ThreadPool::run(unsigned int num_threads, size_t job_count, job_cb_t cb)
+{
+    if( num_threads <= 1 || job_count <= 1 )
+    {
+        for(size_t i = 0; i < job_count; i ++)
+            cb(0, i);
+        return ;
+    }
+    if( num_threads > job_count )
+        num_threads = static_cast<unsigned int>(job_count);
+
+    ::std::vector< ::std::unique_ptr<WorkerQueue> > queues;
+    for(unsigned int i = 0; i < num_threads; i ++)
+    {
+        queues.push_back(::std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+        size_t first = job_count * i / num_threads;
+        size_t last = job_count * (i+1) / num_threads;
+        for(size_t j = first; j < last; j ++)
+            queues.back()->jobs.push_back(j);
+    }
+
+    ::std::atomic<bool> failed { false };
+    ::std::mutex    error_lock;
+    ::std::exception_ptr    error;
+
+    auto worker = [&](unsigned int idx) {
+        try
+        {
+            size_t job;
+            while( !failed.load() )
+            {
+                if( !queues[idx]->pop_own(job) )
+                {
+                    bool found = false;
+                    for(unsigned int ofs = 1; ofs < num_threads && !found; ofs ++)
+                    {
+                        found = queues[(idx + ofs) % num_threads]->steal(job);
+                    }
+                    // All queues are empty (jobs never spawn new jobs), so this worker is done
+                    if( !found )
+                        break;
+                }
+                cb(idx, job);
+            }
+        }
+        catch(...)
+        {
+            ::std::lock_guard<::std::mutex> _lh(error_lock);
+            if( !error )
+                error = ::std::current_exception();
+            failed = true;
+        }
+        };
+
+    ::std::vector< ::std::thread >  threads;
+    for(unsigned int i = 1; i < num_threads; i ++)
+        threads.push_back(::std::thread(worker, i));
+    // The calling thread acts as worker zero
+    worker(0);
+    for(auto& t : threads)
+        t.join();
+
+    if( error )
+        ::std::rethrow_exception(error);
+}
@@ -199,6 +199,7 @@ void Trans_AutoImpl_Clone(State& state, ::HIR::TypeRef ty)
     auto& list = state.crate.m_trait_impls[state.lang_Clone].get_list_for_type_mut(impl.m_type);
     list.push_back( box$(impl) );
     state.crate.m_all_trait_impls[state.lang_Clone].get_list_for_type_mut(list.back()->m_type).push_back( list.back().get() );
+    state.crate.m_trait_impl_cache.clear();
 }
 
 namespace {
@@ -304,9 +305,16 @@ void Trans_AutoImpls(::HIR::Crate& crate, TransList& trans_list)
             //DEBUG("add_function(" << p << ")");
             auto e = trans_list.add_function(::std::move(p));
 
-            const auto* impl_list = impl_list_it->second.get_list_for_type(ty);
-            ASSERT_BUG(Span(), impl_list, "No impl list of Clone for " << ty);
-            auto& impl = **::std::find_if( impl_list->begin(), impl_list->end(), [&](const auto& i){ return i->m_type == ty; });
+            const ::HIR::TraitImpl* impl_ptr = nullptr;
+            impl_list_it->second.iterate_lists_for_type(ty, [&](const auto& impl_list) {
+                auto it = ::std::find_if( impl_list.begin(), impl_list.end(), [&](const auto& i){ return i->m_type == ty; });
+                if( it == impl_list.end() )
+                    return false;
+                impl_ptr = it->get();
+                return true;
+                });
+            ASSERT_BUG(Span(), impl_ptr, "No impl of Clone for " << ty);
+            const auto& impl = *impl_ptr;
             assert( impl.m_methods.size() == 1 );
             e->ptr = &impl.m_methods.begin()->second.data;
         }
@@ -27,7 +27,7 @@ void Trans_Codegen(const ::std::string& outfile, CodegenOutput out_ty, const Tra
     }
     else if( opt.mode == "c" )
     {
-        codegen = Trans_Codegen_GetGeneratorC(crate, outfile);
+        codegen = Trans_Codegen_GetGeneratorC(crate, outfile, opt);
     }
     else
     {
@@ -169,6 +169,14 @@ void Trans_Codegen(const ::std::string& outfile, CodegenOutput out_ty, const Tra
 
 
     // 4. Emit function code
+    struct FunctionCode {
+        const ::HIR::Path*  path;
+        const TransList_Function*   ent;
+        const ::MIR::FunctionPointer*   code;
+        bool is_extern;
+        unsigned int unit;
+    };
+    ::std::vector<FunctionCode> fcn_code;
     for(const auto& ent : list.m_functions)
     {
         if( ent.second->ptr && ent.second->ptr->m_code.m_mir && !ent.second->force_prototype )
@@ -176,8 +184,6 @@ void Trans_Codegen(const ::std::string& outfile, CodegenOutput out_ty, const Tra
             const auto& path = ent.first;
             const auto& fcn = *ent.second->ptr;
             const auto& pp = ent.second->pp;
-            TRACE_FUNCTION_F(path);
-            DEBUG("FUNCTION CODE " << path);
             // `is_extern` is set if there's no HIR (i.e. this function is from an external crate)
             bool is_extern = ! static_cast<bool>(fcn.m_code);
             // If this is a provided trait method, it needs to be monomorphised too.
@@ -188,13 +194,60 @@ void Trans_Codegen(const ::std::string& outfile, CodegenOutput out_ty, const Tra
 
                 // TODO: Flag that this should be a weak (or weak-er) symbol?
                 // - If it's from an external crate, it should be weak, but what about local ones?
-                codegen->emit_function_code(path, fcn, ent.second->pp, is_extern,  ent.second->monomorphised.code);
+                fcn_code.push_back(FunctionCode { &path, ent.second.get(), &ent.second->monomorphised.code, is_extern, 0 });
             }
             else {
-                codegen->emit_function_code(path, fcn, pp, is_extern,  fcn.m_code.m_mir);
+                fcn_code.push_back(FunctionCode { &path, ent.second.get(), &fcn.m_code.m_mir, is_extern, 0 });
             }
         }
     }
+    // - Incremental builds pick units by a hash of the item name, so editing one function only changes the
+    //   content (and hence the object) of the unit that contains it.
+    if( opt.codegen_units > 1 && !opt.incremental_dir.empty() )
+    {
+        for(auto& fc : fcn_code)
+        {
+            // FNV-1a, as the assignment must be stable between runs (unlike `std::hash`)
+            uint64_t    h = 0xcbf29ce484222325ull;
+            for(char c : FMT(*fc.path))
+            {
+                h ^= static_cast<uint8_t>(c);
+                h *= 0x100000001b3ull;
+            }
+            fc.unit = static_cast<unsigned int>(h % opt.codegen_units);
+        }
+    }
+    // - Split the bodies between codegen units, largest first into whichever unit has the least code so far.
+    else if( opt.codegen_units > 1 )
+    {
+        auto get_weight = [](const ::MIR::Function& fcn) {
+            size_t rv = 0;
+            for(const auto& blk : fcn.blocks)
+                rv += 1 + blk.statements.size();
+            return rv;
+            };
+        ::std::vector<::std::pair<size_t, FunctionCode*>>   by_size;
+        for(auto& fc : fcn_code)
+            by_size.push_back(::std::make_pair( get_weight(**fc.code), &fc ));
+        ::std::stable_sort(by_size.begin(), by_size.end(), [](const auto& a, const auto& b){ return a.first > b.first; });
+
+        ::std::vector<size_t>   unit_sizes(opt.codegen_units);
+        for(auto& e : by_size)
+        {
+            auto it = ::std::min_element(unit_sizes.begin(), unit_sizes.end());
+            *it += e.first;
+            e.second->unit = it - unit_sizes.begin();
+        }
+        DEBUG("Codegen unit sizes: [" << unit_sizes << "]");
+    }
+    for(const auto& fc : fcn_code)
+    {
+        const auto& path = *fc.path;
+        TRACE_FUNCTION_F(path);
+        DEBUG("FUNCTION CODE " << path << " (unit " << fc.unit << ")");
+        codegen->set_codegen_unit(fc.unit);
+        codegen->emit_function_code(path, *fc.ent->ptr, fc.ent->pp, fc.is_extern, *fc.code);
+    }
 
     codegen->finalise(opt, out_ty, hir_file);
 }
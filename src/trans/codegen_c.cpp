@@ -19,6 +19,16 @@
 #include "target.hpp"
 #include "allocator.hpp"
 #include <iomanip>
+#include <thread>
+#include <atomic>
+#include <jobserver.h>
+#include <unordered_set>
+#include <unordered_map>
+#ifdef _WIN32
+# include <direct.h>    // _mkdir
+#else
+# include <sys/stat.h>  // mkdir
+#endif
 
 namespace {
     struct FmtShell
@@ -99,6 +109,47 @@ namespace {
     };
 }
 
+namespace {
+    // FNV-1a hashing of generated files, used for the incremental unit manifest (see `-C incremental`)
+    uint64_t hash_bytes(uint64_t h, const char* data, size_t len)
+    {
+        for(size_t i = 0; i < len; i ++)
+        {
+            h ^= static_cast<uint8_t>(data[i]);
+            h *= 0x100000001b3ull;
+        }
+        return h;
+    }
+    ::std::string read_file(const ::std::string& path)
+    {
+        ::std::ifstream is(path, ::std::ios::binary);
+        return ::std::string(::std::istreambuf_iterator<char>(is), ::std::istreambuf_iterator<char>());
+    }
+
+    // Run a command and capture its standard output
+    ::std::string read_command_output(const ::std::string& cmd)
+    {
+        ::std::string   rv;
+#ifdef _WIN32
+        FILE* fp = _popen(cmd.c_str(), "r");
+#else
+        FILE* fp = popen(cmd.c_str(), "r");
+#endif
+        if( !fp )
+            return rv;
+        char    buf[256];
+        size_t  n;
+        while( (n = fread(buf, 1, sizeof(buf), fp)) > 0 )
+            rv.append(buf, n);
+#ifdef _WIN32
+        _pclose(fp);
+#else
+        pclose(fp);
+#endif
+        return rv;
+    }
+}
+
 ::std::ostream& operator<<(::std::ostream& os, const FmtShell& x)
 {
     if( x.is_win )
@@ -185,29 +236,43 @@ namespace {
 
         ::std::string   m_outfile_path;
         ::std::string   m_outfile_path_c;
-
-        ::std::ofstream m_of;
+        // Extra codegen units (`-C codegen-units`), each holding a subset of the function bodies
+        // - Types, prototypes, and static declarations go into a shared header (`m_outfile_path_h`)
+        // - Static definitions and shims stay in the main `.c` file (which is also unit #0)
+        ::std::string   m_outfile_path_h;
+        ::std::vector<::std::string>    m_unit_paths;
+
+        ::std::ofstream m_of_c;
+        ::std::ofstream m_of_h;
+        ::std::vector<::std::unique_ptr<::std::ofstream>>   m_of_units;
+        // Current output stream, re-pointed at one of the above files
+        ::std::ostream  m_of;
         const ::MIR::TypeResolve* m_mir_res;
 
         Compiler    m_compiler = Compiler::Gcc;
         struct {
             bool emulated_i128 = false;
             bool disallow_empty_structs = false;
+            /// Annotate borrow arguments with `restrict`/`nonnull` (see `TransOptions::emit_noalias`)
+            bool emit_noalias = false;
         } m_options;
 
 
-        ::std::set< ::HIR::TypeRef> m_emitted_fn_types;
+        ::std::unordered_set< ::HIR::TypeRef, ::std::hash<::HIR::TypeRef>, ::HIR::TypeRefOrdEqual> m_emitted_fn_types;
         ::std::set< const TypeRepr*>    m_embedded_tags;
     public:
-        CodeGenerator_C(const ::HIR::Crate& crate, const ::std::string& outfile):
+        CodeGenerator_C(const ::HIR::Crate& crate, const ::std::string& outfile, const TransOptions& opt):
             m_crate(crate),
             m_resolve(crate),
             m_outfile_path(outfile),
             m_outfile_path_c(outfile + ".c"),
-            m_of(m_outfile_path_c)
+            m_of_c(m_outfile_path_c),
+            m_of(nullptr)
         {
-            ASSERT_BUG(Span(), m_of.is_open(), "Failed to open `" << m_outfile_path_c << "` for writing");
+            ASSERT_BUG(Span(), m_of_c.is_open(), "Failed to open `" << m_outfile_path_c << "` for writing");
+            m_of.rdbuf(m_of_c.rdbuf());
             m_options.emulated_i128 = Target_GetCurSpec().m_backend_c.m_emulated_i128;
+            m_options.emit_noalias = opt.emit_noalias;
             switch(Target_GetCurSpec().m_backend_c.m_codegen_mode)
             {
             case CodegenMode::Gnu11:
@@ -228,6 +293,36 @@ namespace {
                 break;
             }
 
+            if( opt.codegen_units > 1 )
+            {
+                if( m_compiler == Compiler::Msvc )
+                {
+                    WARNING(Span(), W0000, "Multiple codegen units are not supported with MSVC, using one");
+                }
+                else
+                {
+                    m_outfile_path_h = outfile + ".h";
+                    m_of_h.open(m_outfile_path_h);
+                    ASSERT_BUG(Span(), m_of_h.is_open(), "Failed to open `" << m_outfile_path_h << "` for writing");
+                    for(unsigned int i = 1; i < opt.codegen_units; i ++)
+                    {
+                        m_unit_paths.push_back(FMT(outfile << ".cgu" << i << ".c"));
+                        m_of_units.push_back(::std::make_unique<::std::ofstream>(m_unit_paths.back()));
+                        ASSERT_BUG(Span(), m_of_units.back()->is_open(), "Failed to open `" << m_unit_paths.back() << "` for writing");
+                    }
+
+                    // Include the header from every unit (using the file name, as the units are in the same directory)
+                    auto slash_pos = m_outfile_path_h.find_last_of("/\\");
+                    auto header_name = (slash_pos == ::std::string::npos ? m_outfile_path_h : m_outfile_path_h.substr(slash_pos+1));
+                    m_of_c << "#include \"" << header_name << "\"\n";
+                    for(auto& of : m_of_units)
+                    {
+                        *of << "#include \"" << header_name << "\"\n";
+                    }
+                    m_of.rdbuf(m_of_h.rdbuf());
+                }
+            }
+
             m_of
                 << "/*\n"
                 << " * AUTOGENERATED by mrustc\n"
@@ -290,6 +385,12 @@ namespace {
                 m_of
                     << "extern void _Unwind_Resume(void) __attribute__((noreturn));\n"
                     << "#define ALIGNOF(t) __alignof__(t)\n"
+                    // Clang only accepts `unused` on labels
+                    << "#ifdef __clang__\n"
+                    << "# define MRUSTC_COLD_LABEL\n"
+                    << "#else\n"
+                    << "# define MRUSTC_COLD_LABEL __attribute__((cold))\n"
+                    << "#endif\n"
                     ;
                 break;
             case Compiler::Msvc:
@@ -744,10 +845,34 @@ namespace {
 
         ~CodeGenerator_C() {}
 
+        void set_codegen_unit(unsigned int idx) override
+        {
+            if( m_outfile_path_h.empty() )
+                return ;
+            m_of.rdbuf( idx == 0 ? m_of_c.rdbuf() : m_of_units.at(idx-1)->rdbuf() );
+        }
+
+        // Assembly label for an item that would be `static` in a single-unit build.
+        // - With multiple units these are hidden globals instead, so the crate name is appended to avoid
+        //   clashing with another crate's copy of the same (monomorphised) item.
+        void emit_unit_local_label(const ::HIR::Path& p)
+        {
+            m_of << " asm(\"";
+            if (Target_GetCurSpec().m_os_name == "macos") // Not macOS only, but all Apple platforms.
+                m_of << "_";
+            m_of << Trans_Mangle(p) << "_C";
+            for(const char* c = m_crate.m_crate_name.c_str(); *c; c ++)
+                m_of << (isalnum(*c) ? *c : '_');
+            m_of << "\")";
+        }
+
         void finalise(const TransOptions& opt, CodegenOutput out_ty, const ::std::string& hir_file) override
         {
             const bool create_shims = (out_ty == CodegenOutput::Executable);
 
+            // Shims and `main` go in the main file
+            this->set_codegen_unit(0);
+
             // TODO: Support dynamic libraries too
             // - No main, but has the rest.
             // - Well... for cdylibs that's the case, for rdylibs it's not
@@ -907,8 +1032,18 @@ namespace {
             }
 
             m_of.flush();
-            m_of.close();
-            ASSERT_BUG(Span(), !m_of.bad(), "Error set on output stream for: " << m_outfile_path_c);
+            m_of_c.close();
+            ASSERT_BUG(Span(), !m_of_c.bad(), "Error set on output stream for: " << m_outfile_path_c);
+            if( !m_outfile_path_h.empty() )
+            {
+                m_of_h.close();
+                ASSERT_BUG(Span(), !m_of_h.bad(), "Error set on output stream for: " << m_outfile_path_h);
+                for(size_t i = 0; i < m_of_units.size(); i ++)
+                {
+                    m_of_units[i]->close();
+                    ASSERT_BUG(Span(), !m_of_units[i]->bad(), "Error set on output stream for: " << m_unit_paths[i]);
+                }
+            }
 
             class LinkList: private StringList
             {
@@ -1133,6 +1268,18 @@ namespace {
 
             // Execute $CC with the required libraries
             StringList  args;
+            // With multiple codegen units, each unit is first compiled to an object (in parallel)
+            ::std::vector<StringList>   unit_args;
+            ::std::vector<::std::string>    unit_objs;
+            ::std::vector<::std::string>    unit_srcs;
+            // Incremental cache entries are prefixed with a hash of the full output path, so outputs with the same
+            // file name in different directories don't overwrite each other's objects and manifest.
+            ::std::string   incremental_prefix;
+            if( !opt.incremental_dir.empty() )
+            {
+                auto h = hash_bytes(0xcbf29ce484222325ull, m_outfile_path.data(), m_outfile_path.size());
+                incremental_prefix = FMT(opt.incremental_dir << "/" << ::std::hex << ::std::setw(16) << ::std::setfill('0') << h << "-");
+            }
 #ifdef _WIN32
             bool is_windows = true;
 #else
@@ -1184,6 +1331,52 @@ namespace {
                     args.push_back("-g");
                 }
                 args.push_back("-fPIC");
+                if( opt.lto )
+                {
+                    args.push_back("-flto");
+                    // Downstream crates might not be linked with LTO, so also include regular code
+                    if( out_ty == CodegenOutput::StaticLibrary || out_ty == CodegenOutput::Object )
+                    {
+                        args.push_back("-ffat-lto-objects");
+                    }
+                }
+                // NOTE: These are also needed on the link (for the profiling runtime, and to apply the profile during LTO)
+                if( !opt.profile_generate_dir.empty() )
+                {
+                    args.push_back("-fprofile-generate=" + opt.profile_generate_dir);
+                }
+                if( !opt.profile_use_dir.empty() )
+                {
+                    args.push_back("-fprofile-use=" + opt.profile_use_dir);
+                    // Crates that weren't exercised by the training run have no profile, which is fine
+                    args.push_back("-Wno-missing-profile");
+                }
+                if( !m_outfile_path_h.empty() )
+                {
+                    for(size_t i = 0; i <= m_unit_paths.size(); i ++)
+                    {
+                        const auto& src_path = (i == 0 ? m_outfile_path_c : m_unit_paths[i-1]);
+                        if( !opt.incremental_dir.empty() )
+                        {
+                            // Objects are kept in the cache directory, so they can be reused by the next build
+                            auto slash_pos = src_path.find_last_of("/\\");
+                            unit_objs.push_back(incremental_prefix + (slash_pos == ::std::string::npos ? src_path : src_path.substr(slash_pos+1)) + ".o");
+                        }
+                        else
+                        {
+                            unit_objs.push_back(src_path + ".o");
+                        }
+                        unit_srcs.push_back(src_path);
+                        unit_args.push_back(StringList());
+                        auto& ua = unit_args.back();
+                        for(const char* a : args)
+                            ua.push_back(::std::string(a));
+                        ua.push_back("-c");
+                        ua.push_back("-o");
+                        ua.push_back(unit_objs.back());
+                        ua.push_back(src_path.c_str());
+                    }
+                }
                 args.push_back("-o");
                 switch(out_ty)
                 {
@@ -1196,7 +1389,15 @@ namespace {
                     args.push_back(m_outfile_path+".o");
                     break;
                 }
-                args.push_back(m_outfile_path_c.c_str());
+                if( !m_outfile_path_h.empty() )
+                {
+                    for(const auto& o : unit_objs)
+                        args.push_back(o.c_str());
+                }
+                else
+                {
+                    args.push_back(m_outfile_path_c.c_str());
+                }
                 switch(out_ty)
                 {
                 case CodegenOutput::DynamicLibrary:
@@ -1245,7 +1446,16 @@ namespace {
                     break;
                 case CodegenOutput::StaticLibrary:
                 case CodegenOutput::Object:
-                    args.push_back("-c");
+                    if( !m_outfile_path_h.empty() )
+                    {
+                        // Merge the unit objects into the single object expected by downstream crates
+                        args.push_back("-r");
+                        args.push_back("-nostdlib");
+                    }
+                    else
+                    {
+                        args.push_back("-c");
+                    }
                     break;
                 }
                 break;
@@ -1272,6 +1482,15 @@ namespace {
                     //args.push_back("/O2");
                     break;
                 }
+                if( opt.lto )
+                {
+                    // Whole program optimisation, the linker picks this up from the objects
+                    args.push_back("/GL");
+                }
+                if( !opt.profile_generate_dir.empty() || !opt.profile_use_dir.empty() )
+                {
+                    WARNING(Span(), W0000, "Profile-guided optimisation is not supported with MSVC, ignoring");
+                }
                 if( opt.emit_debug_info )
                 {
                     args.push_back("/DEBUG");
@@ -1340,59 +1559,184 @@ namespace {
                 break;
             }
 
-            ::std::stringstream cmd_ss;
-            if (is_windows)
-            {
-                cmd_ss << "echo \"\" & ";
-            }
-            std::string command_file = m_outfile_path + "_cmd.txt";
-            std::ofstream   command_file_stream;
-            bool use_arg_file = arg_file_start > 0;
-            if(use_arg_file) {
-                command_file_stream.open(command_file);
-                ASSERT_BUG(Span(), command_file_stream.is_open(), "Failed to open command file `" << command_file << "` for writing");
-            }
-            size_t i = -1;
-            for(const auto& arg : args.get_vec())
-            {
-                i ++;
-                auto& out_ss = (use_arg_file && i >= arg_file_start ? static_cast<::std::ostream&>(command_file_stream) : cmd_ss);
-                if(strcmp(arg, "&") == 0 && is_windows) {
-                    out_ss << "&";
+            auto format_command = [&](const StringList& args, const ::std::string& command_file)->::std::string {
+                ::std::stringstream cmd_ss;
+                if (is_windows)
+                {
+                    cmd_ss << "echo \"\" & ";
                 }
-                else {
-                    if( is_windows && strchr(arg, ' ') == nullptr ) {
-                        out_ss << arg << " ";
+                std::ofstream   command_file_stream;
+                bool use_arg_file = arg_file_start > 0;
+                if(use_arg_file) {
+                    command_file_stream.open(command_file);
+                    ASSERT_BUG(Span(), command_file_stream.is_open(), "Failed to open command file `" << command_file << "` for writing");
+                }
+                size_t i = -1;
+                for(const auto& arg : args.get_vec())
+                {
+                    i ++;
+                    auto& out_ss = (use_arg_file && i >= arg_file_start ? static_cast<::std::ostream&>(command_file_stream) : cmd_ss);
+                    if(strcmp(arg, "&") == 0 && is_windows) {
+                        out_ss << "&";
                     }
                     else {
-                        out_ss << "\"" << FmtShell(arg, is_windows) << "\" ";
+                        if( is_windows && strchr(arg, ' ') == nullptr ) {
+                            out_ss << arg << " ";
+                        }
+                        else {
+                            out_ss << "\"" << FmtShell(arg, is_windows) << "\" ";
+                        }
                     }
                 }
+                if(use_arg_file) {
+                    cmd_ss << "@\"" << FmtShell(command_file, is_windows) << "\"";
+                    command_file_stream.close();
+                    ASSERT_BUG(Span(), !command_file_stream.bad(), "Error set on output stream for: " << command_file);
+                }
+                return cmd_ss.str();
+                };
+            auto run_command = [](const ::std::string& cmd)->int {
+                int ec = system(cmd.c_str());
+                if( ec == -1 )
+                {
+                    ::std::cerr << "C Compiler failed to execute (system returned -1)" << ::std::endl;
+                    perror("system");
+                }
+                else if( ec != 0 )
+                {
+                    ::std::cerr << "C Compiler failed to execute - error code " << ec << ::std::endl;
+                }
+                return ec;
+                };
+
+            // The incremental cache directory holds the unit objects (and their command files)
+            if( !opt.incremental_dir.empty() && !unit_args.empty() )
+            {
+#if _WIN32
+                _mkdir(opt.incremental_dir.c_str());
+#else
+                mkdir(opt.incremental_dir.c_str(), 0755);
+#endif
             }
-            if(use_arg_file) {
-                cmd_ss << "@\"" << FmtShell(command_file, is_windows) << "\"";
-                command_file_stream.close();
-                ASSERT_BUG(Span(), !command_file_stream.bad(), "Error set on output stream for: " << m_outfile_path_c);
+            ::std::vector<::std::string>    unit_cmds;
+            for(size_t i = 0; i < unit_args.size(); i ++)
+            {
+                unit_cmds.push_back( format_command(unit_args[i], unit_objs[i] + "_cmd.txt") );
+                ::std::cout << "Running command - " << unit_cmds.back() << ::std::endl;
             }
-            //DEBUG("- " << cmd_ss.str());
-            ::std::cout << "Running command - " << cmd_ss.str() << ::std::endl;
+            auto cmd = format_command(args, m_outfile_path + "_cmd.txt");
+            //DEBUG("- " << cmd);
+            ::std::cout << "Running command - " << cmd << ::std::endl;
             if( opt.build_command_file != "" )
             {
-                ::std::cerr << "INVOKE CC: " << cmd_ss.str() << ::std::endl;
-                ::std::ofstream(opt.build_command_file) << cmd_ss.str() << ::std::endl;
+                ::std::ofstream cmd_file(opt.build_command_file);
+                for(const auto& c : unit_cmds)
+                {
+                    ::std::cerr << "INVOKE CC: " << c << ::std::endl;
+                    cmd_file << c << ::std::endl;
+                }
+                ::std::cerr << "INVOKE CC: " << cmd << ::std::endl;
+                cmd_file << cmd << ::std::endl;
             }
             else
             {
-                int ec = system(cmd_ss.str().c_str());
-                if( ec == -1 )
+                // Incremental: A unit's fingerprint covers its source, the shared header, the compiler's identity (its
+                // `--version` output), and the compiler arguments. If it matches the manifest from the previous build
+                // (and the object is still there), skip the compile.
+                ::std::vector<::std::string>    unit_fingerprints(unit_cmds.size());
+                ::std::vector<bool> unit_reused(unit_cmds.size());
+                ::std::string   manifest_path;
+                if( !opt.incremental_dir.empty() && !unit_cmds.empty() )
                 {
-                    ::std::cerr << "C Compiler failed to execute (system returned -1)" << ::std::endl;
-                    perror("system");
-                    exit(1);
+                    auto slash_pos = m_outfile_path.find_last_of("/\\");
+                    manifest_path = incremental_prefix + (slash_pos == ::std::string::npos ? m_outfile_path : m_outfile_path.substr(slash_pos+1)) + ".units";
+
+                    // Manifest format: one `<object path> <fingerprint>` pair per line
+                    ::std::map<::std::string, ::std::string>    prev_fingerprints;
+                    {
+                        ::std::ifstream is(manifest_path);
+                        ::std::string   obj, fp;
+                        while( is >> obj >> fp )
+                            prev_fingerprints[obj] = fp;
+                    }
+
+                    auto header = read_file(m_outfile_path_h);
+                    ::std::stringstream version_cmd;
+                    version_cmd << "\"" << FmtShell(unit_args[0].get_vec()[0], is_windows) << "\" --version 2>&1";
+                    auto cc_version = read_command_output(version_cmd.str());
+                    auto common_hash = hash_bytes(0xcbf29ce484222325ull, header.data(), header.size());
+                    common_hash = hash_bytes(common_hash, cc_version.data(), cc_version.size());
+                    for(size_t i = 0; i < unit_cmds.size(); i ++)
+                    {
+                        auto src = read_file(unit_srcs[i]);
+                        auto h = hash_bytes(common_hash, src.data(), src.size());
+                        for(const char* a : unit_args[i])
+                            h = hash_bytes(h, a, strlen(a)+1);
+                        unit_fingerprints[i] = FMT(::std::hex << ::std::setw(16) << ::std::setfill('0') << h);
+
+                        auto it = prev_fingerprints.find(unit_objs[i]);
+                        unit_reused[i] = it != prev_fingerprints.end() && it->second == unit_fingerprints[i] && ::std::ifstream(unit_objs[i]).good();
+                        // The profile data isn't part of the fingerprint, so always recompile when using it
+                        if( !opt.profile_use_dir.empty() )
+                        {
+                            unit_reused[i] = false;
+                        }
+                        if( unit_reused[i] )
+                        {
+                            ::std::cout << "Reusing " << unit_objs[i] << " (unchanged)" << ::std::endl;
+                        }
+                    }
                 }
-                else if( ec != 0 )
+
+                // Compile all (changed) units concurrently, then run the final link
+                // - If started by `minicargo` (or `make`) with a jobserver, each compile holds a job token so
+                //   the number of running compilers stays within the build's overall job count.
+                // - Otherwise tokens don't limit anything, so at most one compiler per hardware thread is run.
+                ::std::vector<int>  unit_rvs(unit_cmds.size());
+                ::std::vector<size_t>   unit_queue;
+                for(size_t i = 0; i < unit_cmds.size(); i ++)
+                {
+                    if( !unit_reused[i] )
+                        unit_queue.push_back(i);
+                }
+                size_t  num_threads = unit_queue.size();
+                if( !JobServer::is_active() )
+                {
+                    num_threads = ::std::min<size_t>(num_threads, ::std::max(1u, ::std::thread::hardware_concurrency()));
+                }
+                ::std::atomic<size_t>   next_unit { 0 };
+                ::std::vector<::std::thread>    threads;
+                for(size_t t = 0; t < num_threads; t ++)
+                {
+                    threads.push_back(::std::thread([&]() {
+                        size_t  qi;
+                        while( (qi = next_unit++) < unit_queue.size() )
+                        {
+                            JobServer::Token    token;
+                            unit_rvs[unit_queue[qi]] = run_command(unit_cmds[unit_queue[qi]]);
+                        }
+                        }));
+                }
+                for(auto& t : threads)
+                    t.join();
+                if( !manifest_path.empty() )
+                {
+                    // Only record units that built successfully, so a failed unit is retried next time
+                    ::std::ofstream os(manifest_path);
+                    for(size_t i = 0; i < unit_cmds.size(); i ++)
+                    {
+                        if( unit_rvs[i] == 0 )
+                            os << unit_objs[i] << " " << unit_fingerprints[i] << "\n";
+                    }
+                }
+                for(int ec : unit_rvs)
+                {
+                    if( ec != 0 )
+                        exit(1);
+                }
+
+                if( run_command(cmd) != 0 )
                 {
-                    ::std::cerr << "C Compiler failed to execute - error code " << ec << ::std::endl;
                     exit(1);
                 }
             }
@@ -1803,6 +2147,99 @@ namespace {
             m_mir_res = nullptr;
         }
 
+        /// Element layout of a `repr(simd)` struct
+        struct SimdInfo {
+            unsigned count;
+            unsigned item_size;
+            enum Ty {
+                Float,
+                Signed,
+                Unsigned,
+            } ty;
+
+            /// Returns false if the elements aren't a primitive type supported by the C backend
+            static bool try_for_ty(const CodeGenerator_C& self, const HIR::TypeRef& ty, SimdInfo& rv) {
+                const auto* repr = Target_GetTypeRepr(self.sp, self.m_resolve, ty);
+                MIR_ASSERT(*self.m_mir_res, repr, "No repr for SIMD type " << ty);
+                if( repr->fields.empty() )
+                    return false;
+                // Either `struct T(E, E, ...)` or `struct T([E; N])`
+                const auto* ty_val = &repr->fields[0].ty;
+                if( const auto* te = ty_val->data().opt_Array() )
+                    ty_val = &te->inner;
+                if( !ty_val->data().is_Primitive() )
+                    return false;
+                size_t size_slot = repr->size, size_val = 0;
+                Target_GetSizeOf(self.sp, self.m_resolve, *ty_val, size_val);
+
+                MIR_ASSERT(*self.m_mir_res, size_val > 0 && size_slot >= size_val, size_slot << " < " << size_val);
+                MIR_ASSERT(*self.m_mir_res, size_slot / size_val * size_val == size_slot, size_slot << " not a multiple of " << size_val);
+
+                rv.item_size = size_val;
+                rv.count = size_slot / size_val;
+                switch(ty_val->data().as_Primitive())
+                {
+                case ::HIR::CoreType::I8:   rv.ty = Signed; break;
+                case ::HIR::CoreType::I16:  rv.ty = Signed; break;
+                case ::HIR::CoreType::I32:  rv.ty = Signed; break;
+                case ::HIR::CoreType::I64:  rv.ty = Signed; break;
+                //case ::HIR::CoreType::I128: rv.ty = Signed; break;
+                case ::HIR::CoreType::U8:   rv.ty = Unsigned; break;
+                case ::HIR::CoreType::U16:  rv.ty = Unsigned; break;
+                case ::HIR::CoreType::U32:  rv.ty = Unsigned; break;
+                case ::HIR::CoreType::U64:  rv.ty = Unsigned; break;
+                //case ::HIR::CoreType::U128: rv.ty = Unsigned; break;
+                case ::HIR::CoreType::F32:  rv.ty = Float;  break;
+                case ::HIR::CoreType::F64:  rv.ty = Float;  break;
+                default:
+                    return false;
+                }
+                return true;
+            }
+            static SimdInfo for_ty(const CodeGenerator_C& self, const HIR::TypeRef& ty) {
+                SimdInfo    rv;
+                if( !try_for_ty(self, ty, rv) )
+                    MIR_BUG(*self.m_mir_res, "Invalid SIMD type inner - " << ty);
+                return rv;
+            }
+            void emit_val_ty(CodeGenerator_C& self) const {
+                switch(ty)
+                {
+                case Float: self.m_of << (item_size == 4 ? "float" : "double"); break;
+                case Signed:    self.m_of << "int" << (item_size*8) << "_t";    break;
+                case Unsigned:  self.m_of << "uint" << (item_size*8) << "_t";   break;
+                }
+            }
+            /// Unsigned type used for wrapping integer arithmetic on the lanes (signed overflow is UB in C, and
+            /// narrower lanes would otherwise be promoted to `int`)
+            void emit_wrapping_ty(CodeGenerator_C& self) const {
+                self.m_of << "uint" << (item_size < 4 ? 32 : item_size*8) << "_t";
+            }
+            /// GCC/Clang vector types must have a power of two element count
+            bool is_vectorisable() const {
+                return (count & (count - 1)) == 0;
+            }
+        };
+        /// Returns true if `ty` (a `repr(simd)` struct) has a vector view type (`v_<struct>`) defined
+        bool simd_has_vector_type(const ::HIR::TypeRef& ty) const
+        {
+            if( m_compiler != Compiler::Gcc )
+                return false;
+            const auto* te = ty.data().opt_Path();
+            if( !te || !te->binding.is_Struct() || te->binding.as_Struct()->m_repr != ::HIR::Struct::Repr::Simd )
+                return false;
+            SimdInfo    info;
+            return SimdInfo::try_for_ty(*this, ty, info) && info.is_vectorisable();
+        }
+        /// Emit `ty`'s vector view of `val` (a `repr(simd)` struct lvalue)
+        template<typename Cb>
+        void emit_simd_vector_access(const ::HIR::TypeRef& ty, Cb emit_val)
+        {
+            m_of << "(*(v_" << Trans_Mangle(ty.data().as_Path().path.m_data.as_Generic()) << "*)&";
+            emit_val();
+            m_of << ")";
+        }
+
         void emit_struct(const Span& sp, const ::HIR::GenericPath& p, const ::HIR::Struct& item) override
         {
             ::MIR::Function empty_fcn;
@@ -1826,6 +2263,20 @@ namespace {
             }
             m_of << "typedef char alignof_assert_" << Trans_Mangle(p) << "[ (ALIGNOF(struct s_" << Trans_Mangle(p) << ") == " << repr->align << ") ? 1 : -1 ];\n";
 
+            // SIMD types get a GCC/Clang vector view (with the struct's alignment, and allowed to alias it), used to
+            // lower the `platform:simd_*` intrinsics to native vector operations.
+            if( simd_has_vector_type(item_ty) )
+            {
+                auto info = SimdInfo::for_ty(*this, item_ty);
+                m_of << "typedef "; info.emit_val_ty(*this);
+                m_of << " v_" << Trans_Mangle(p) << " __attribute__((vector_size(" << repr->size << "), aligned(" << repr->align << "), may_alias));\n";
+                // Signed lanes also get an unsigned view, for wrapping arithmetic
+                if( info.ty == SimdInfo::Signed )
+                {
+                    m_of << "typedef uint" << (info.item_size*8) << "_t vu_" << Trans_Mangle(p) << " __attribute__((vector_size(" << repr->size << "), aligned(" << repr->align << "), may_alias));\n";
+                }
+            }
+
             m_mir_res = nullptr;
         }
         void emit_union(const Span& sp, const ::HIR::GenericPath& p, const ::HIR::Union& item) override
@@ -2230,6 +2681,10 @@ namespace {
 
             TRACE_FUNCTION_F(p);
             auto type = params.monomorph(m_resolve, item.m_type);
+            // With multiple codegen units, the header only declares the static (it's defined in the main file)
+            if( !m_outfile_path_h.empty() ) {
+                m_of << "extern ";
+            }
             switch(item.m_linkage.type)
             {
             case HIR::Linkage::Type::External:
@@ -2261,13 +2716,31 @@ namespace {
                 }
             }
             if( item.m_params.is_generic() ) {
-                m_of << "static ";
+                if( m_outfile_path_h.empty() ) {
+                    m_of << "static ";
+                }
+                else {
+                    m_of << "__attribute__((visibility(\"hidden\"))) ";
+                }
             }
             emit_static_ty(type, p, /*is_proto=*/true);
+            if( item.m_params.is_generic() && !m_outfile_path_h.empty() ) {
+                emit_unit_local_label(p);
+            }
             m_of << ";";
             m_of << "\t// static " << p << " : " << type;
             m_of << "\n";
 
+            if( !m_outfile_path_h.empty() )
+            {
+                // Tentative definition in the main file, covers statics that have no emitted value
+                // - Attributes are inherited from the declaration in the header
+                this->set_codegen_unit(0);
+                emit_static_ty(type, p, /*is_proto=*/false);
+                m_of << ";\n";
+                m_of.rdbuf(m_of_h.rdbuf());
+            }
+
             m_mir_res = nullptr;
         }
         void emit_static_local(const ::HIR::Path& p, const ::HIR::Static& item, const Trans_Params& params, const EncodedLiteral& encoded) override
@@ -2279,9 +2752,11 @@ namespace {
             TRACE_FUNCTION_F(p);
 
             auto type = params.monomorph(m_resolve, item.m_type);
+            // Static values are defined in the main file
+            this->set_codegen_unit(0);
             // statics that are zero do not require initializers, since they will be initialized to zero on program startup.
             if( !is_zero_literal(type, encoded, params)) {
-                if( item.m_params.is_generic() ) {
+                if( item.m_params.is_generic() && m_outfile_path_h.empty() ) {
                     m_of << "static ";
                 }
                 bool is_packed = emit_static_ty(type, p, /*is_proto=*/false);
@@ -2526,6 +3001,10 @@ namespace {
             {
                 m_of << "extern ";
             }
+            if( item.m_markings.is_cold && m_compiler == Compiler::Gcc )
+            {
+                m_of << "__attribute__((cold)) ";
+            }
             emit_function_header(p, item, params);
             if( item.m_linkage.name != "" )
             {
@@ -2568,7 +3047,12 @@ namespace {
             }
             if( is_extern_def )
             {
-                m_of << "static ";
+                if( m_outfile_path_h.empty() ) {
+                    m_of << "static ";
+                }
+                else {
+                    m_of << "__attribute__((visibility(\"hidden\"))) ";
+                }
             }
             switch(item.m_linkage.type)
             {
@@ -2588,7 +3072,31 @@ namespace {
                 }
                 break;
             }
+            // References are never null (the attribute carries over to the definition)
+            if( m_options.emit_noalias && m_compiler == Compiler::Gcc )
+            {
+                bool is_first = true;
+                for(unsigned int i = 0; i < item.m_args.size(); i ++)
+                {
+                    auto ty = params.monomorph(m_resolve, item.m_args[i].second);
+                    if( ty.data().is_Borrow() && !this->is_dst(ty.data().as_Borrow().inner) )
+                    {
+                        m_of << (is_first ? "__attribute__((nonnull(" : ",") << (i+1);
+                        is_first = false;
+                    }
+                }
+                if( !is_first )
+                    m_of << "))) ";
+            }
+            // #[cold] - GCC treats paths leading to calls as unlikely, and optimises the function for size
+            if( item.m_markings.is_cold && m_compiler == Compiler::Gcc )
+            {
+                m_of << "__attribute__((cold)) ";
+            }
             emit_function_header(p, item, params);
+            if( is_extern_def && !m_outfile_path_h.empty() && item.m_linkage.name == "" ) {
+                emit_unit_local_label(p);
+            }
             m_of << ";\n";
 
             m_mir_res = nullptr;
@@ -2608,10 +3116,14 @@ namespace {
             m_mir_res = &mir_res;
 
             m_of << "// " << p << "\n";
-            if( is_extern_def ) {
+            if( is_extern_def && m_outfile_path_h.empty() ) {
                 m_of << "static ";
             }
-            emit_function_header(p, item, params);
+            ::std::vector<bool> restrict_args;
+            if( m_options.emit_noalias ) {
+                restrict_args = get_restrict_args(item, params, *code);
+            }
+            emit_function_header(p, item, params, m_options.emit_noalias ? &restrict_args : nullptr);
             m_of << "\n";
             m_of << "{\n";
             // Variables
@@ -2752,8 +3264,23 @@ namespace {
                 m_of << "#else\n";
             }
 
+            // Move cold blocks (panic paths) to the end of the function, so the hot path is contiguous
+            // - The first block is always emitted first, as it's the entrypoint
+            const auto cold_blocks = get_cold_blocks(mir_res, *code);
+            ::std::vector<unsigned> bb_order;
+            bb_order.reserve(code->blocks.size());
             for(unsigned int i = 0; i < code->blocks.size(); i ++)
+                if( i == 0 || !cold_blocks[i] )
+                    bb_order.push_back(i);
+            for(unsigned int i = 1; i < code->blocks.size(); i ++)
+                if( cold_blocks[i] )
+                    bb_order.push_back(i);
+
+            for(size_t bb_idx = 0; bb_idx < bb_order.size(); bb_idx ++)
             {
+                const unsigned i = bb_order[bb_idx];
+                const size_t prev_bb = (bb_idx > 0 ? bb_order[bb_idx-1] : SIZE_MAX);
+                const size_t next_bb = (bb_idx+1 < bb_order.size() ? bb_order[bb_idx+1] : SIZE_MAX);
                 TRACE_FUNCTION_F(p << " bb" << i);
 
                 // HACK: Ignore any blocks that only contain `diverge;`
@@ -2780,18 +3307,18 @@ namespace {
                 }
                 else if( bb_use_counts.at(i) == 1 )
                 {
-                    if( i > 0 && (TU_TEST1(code->blocks[i-1].terminator, Goto, == i) || TU_TEST1(code->blocks[i-1].terminator, Call, .ret_block == i)) )
+                    if( prev_bb != SIZE_MAX && (TU_TEST1(code->blocks[prev_bb].terminator, Goto, == i) || TU_TEST1(code->blocks[prev_bb].terminator, Call, .ret_block == i)) )
                     {
                         // Don't print the label, only use is previous block
                     }
                     else
                     {
-                        m_of << "bb" << i << ":\n";
+                        emit_block_label(i, cold_blocks[i]);
                     }
                 }
                 else
                 {
-                    m_of << "bb" << i << ":\n";
+                    emit_block_label(i, cold_blocks[i]);
                 }
 
                 for(const auto& stmt : code->blocks[i].statements)
@@ -2817,7 +3344,7 @@ namespace {
                     m_of << "\t_Unwind_Resume();\n";
                     }
                 TU_ARMA(Goto, e) {
-                    if( e == i+1 )
+                    if( e == next_bb )
                     {
                         // Let it flow on to the next block
                     }
@@ -2830,7 +3357,15 @@ namespace {
                     m_of << "\tgoto bb" << e << "; /* panic */\n";
                     }
                 TU_ARMA(If, e) {
-                    m_of << "\tif("; emit_lvalue(e.cond); m_of << ") goto bb" << e.bb0 << "; else goto bb" << e.bb1 << ";\n";
+                    if( m_compiler == Compiler::Gcc && cold_blocks[e.bb0] != cold_blocks[e.bb1] )
+                    {
+                        m_of << "\tif( __builtin_expect("; emit_lvalue(e.cond); m_of << ", " << (cold_blocks[e.bb0] ? 0 : 1) << ") )";
+                    }
+                    else
+                    {
+                        m_of << "\tif("; emit_lvalue(e.cond); m_of << ")";
+                    }
+                    m_of << " goto bb" << e.bb0 << "; else goto bb" << e.bb1 << ";\n";
                     }
                 TU_ARMA(Switch, e) {
 
@@ -2878,7 +3413,7 @@ namespace {
                     }
                 TU_ARMA(Call, e) {
                     emit_term_call(mir_res, e, 1);
-                    if( e.ret_block == i+1 )
+                    if( e.ret_block == next_bb )
                     {
                         // Let it flow on to the next block
                     }
@@ -2900,6 +3435,17 @@ namespace {
             m_mir_res = nullptr;
         }
 
+        void emit_block_label(unsigned bb_idx, bool is_cold)
+        {
+            m_of << "bb" << bb_idx << ":";
+            // GCC predicts paths leading to a cold label as unlikely (same as calls to a cold function)
+            if( is_cold && m_compiler == Compiler::Gcc )
+            {
+                m_of << " MRUSTC_COLD_LABEL;";
+            }
+            m_of << "\n";
+        }
+
         void emit_fcn_node(::MIR::TypeResolve& mir_res, const Node& node, unsigned indent_level,  const ::std::set<unsigned>& goto_targets)
         {
             TRACE_FUNCTION_F(node.tag_str());
@@ -5011,7 +5557,140 @@ namespace {
             }
         }
 
-        void emit_function_header(const ::HIR::Path& p, const ::HIR::Function& item, const Trans_Params& params)
+        /// Determine which arguments of a function definition can be `restrict` qualified
+        ///
+        /// `&mut T` is unique, and the target of a `&T` can't change while the borrow is live (unless it contains an
+        /// `UnsafeCell`), matching the cases where rustc emits `noalias`. Arguments that the body overwrites (or
+        /// borrows) are excluded, as the C qualifier applies to the variable, not just the value on entry.
+        ::std::vector<bool> get_restrict_args(const ::HIR::Function& item, const Trans_Params& params, const ::MIR::Function& code)
+        {
+            ::std::vector<bool> rv(item.m_args.size());
+            for(unsigned int i = 0; i < item.m_args.size(); i ++)
+            {
+                auto ty = params.monomorph(m_resolve, item.m_args[i].second);
+                const auto* te = ty.data().opt_Borrow();
+                if( !te || this->is_dst(te->inner) )
+                    continue ;
+                switch(te->type)
+                {
+                case ::HIR::BorrowType::Unique:
+                    rv[i] = true;
+                    break;
+                case ::HIR::BorrowType::Shared:
+                    rv[i] = m_resolve.type_is_interior_mutable(sp, te->inner) == ::HIR::Compare::Unequal;
+                    break;
+                case ::HIR::BorrowType::Owned:
+                    break;
+                }
+            }
+
+            auto cb = [&](const ::MIR::LValue& lv, ::MIR::visit::ValUsage u)->bool {
+                if( lv.m_wrappers.empty() && lv.m_root.is_Argument() && (u == ::MIR::visit::ValUsage::Write || u == ::MIR::visit::ValUsage::Borrow) )
+                {
+                    rv.at(lv.m_root.as_Argument()) = false;
+                }
+                return false;
+                };
+            for(const auto& blk : code.blocks)
+            {
+                for(const auto& stmt : blk.statements)
+                    ::MIR::visit::visit_mir_lvalues(stmt, cb);
+                ::MIR::visit::visit_mir_lvalues(blk.terminator, cb);
+            }
+            return rv;
+        }
+
+        /// Check if a call is to a function that is `#[cold]`, or that never returns (e.g. the panic handlers)
+        bool is_cold_call(const ::MIR::TypeResolve& mir_res, const ::MIR::Terminator::Data_Call& e)
+        {
+            TU_MATCH_HDRA( (e.fcn), {)
+            TU_ARMA(Value, e2) {
+                ::HIR::TypeRef  tmp;
+                const auto& ty = mir_res.get_lvalue_type(tmp, e2);
+                return ty.data().is_Function() && ty.data().as_Function().m_rettype.data().is_Diverge();
+                }
+            TU_ARMA(Intrinsic, e2) {
+                return e2.name == "abort";
+                }
+            TU_ARMA(Path, e2) {
+                const ::HIR::Function* fcn = nullptr;
+                TU_MATCH_HDRA( (e2.m_data), {)
+                TU_ARMA(Generic, pe) {
+                    fcn = &m_crate.get_function_by_path(sp, pe.m_path);
+                    }
+                TU_ARMA(UfcsUnknown, pe) {
+                    }
+                TU_ARMA(UfcsInherent, pe) {
+                    m_resolve.m_crate.find_type_impls(pe.type, [&](const auto& ty)->const auto& { return ty; },
+                        [&](const auto& impl) {
+                            auto it = impl.m_methods.find(pe.item);
+                            if( it != impl.m_methods.end() ) {
+                                fcn = &it->second.data;
+                                return true;
+                            }
+                            return false;
+                        });
+                    }
+                TU_ARMA(UfcsKnown, pe) {
+                    // NOTE: Only the trait's declaration is checked, not the impl
+                    const auto& tr = m_resolve.m_crate.get_trait_by_path(sp, pe.trait.m_path);
+                    fcn = &tr.m_values.find(pe.item)->second.as_Function();
+                    }
+                }
+                return fcn && (fcn->m_markings.is_cold || fcn->m_return.data().is_Diverge());
+                }
+            }
+            throw "";
+        }
+
+        /// Determine which basic blocks are unlikely to be executed
+        ///
+        /// Blocks that end in a cold call (see `is_cold_call`) or that start unwinding are cold, as is any block that
+        /// can only continue into cold blocks. The panic arm of calls isn't followed, as it's not reachable in the
+        /// generated code.
+        ::std::vector<bool> get_cold_blocks(const ::MIR::TypeResolve& mir_res, const ::MIR::Function& code)
+        {
+            ::std::vector<bool> rv(code.blocks.size());
+            for(unsigned int i = 0; i < code.blocks.size(); i ++)
+            {
+                const auto& term = code.blocks[i].terminator;
+                if( term.is_Diverge() || term.is_Panic() ) {
+                    rv[i] = true;
+                }
+                else if( const auto* te = term.opt_Call() ) {
+                    rv[i] = is_cold_call(mir_res, *te);
+                }
+            }
+
+            // Propagate backwards until stable
+            for(bool changed = true; changed; )
+            {
+                changed = false;
+                for(unsigned int i = code.blocks.size(); i --; )
+                {
+                    if( rv[i] )
+                        continue ;
+                    const auto& term = code.blocks[i].terminator;
+                    bool has_targets = false;
+                    bool all_cold = true;
+                    if( const auto* te = term.opt_Call() ) {
+                        has_targets = true;
+                        all_cold = rv[te->ret_block];
+                    }
+                    else {
+                        ::MIR::visit::visit_terminator_target(term, [&](const auto& tgt){ has_targets = true; all_cold &= rv[tgt]; });
+                    }
+                    if( has_targets && all_cold ) {
+                        rv[i] = true;
+                        changed = true;
+                    }
+                }
+            }
+            return rv;
+        }
+
+        /// Emit the signature of a function (`restrict_args` marks arguments to be `restrict` qualified)
+        void emit_function_header(const ::HIR::Path& p, const ::HIR::Function& item, const Trans_Params& params, const ::std::vector<bool>* restrict_args=nullptr)
         {
             ::HIR::TypeRef  tmp;
             const auto& ret_ty = monomorphise_fcn_return(tmp, item, params);
@@ -5034,7 +5713,8 @@ namespace {
                         ss << "\n\t\t";
                         // TODO: If the type has a high alignment, emit as a pointer
                         auto ty = params.monomorph(m_resolve, item.m_args[i].second);
-                        this->emit_ctype( ty, FMT_CB(os, os << (this->type_is_high_align(ty) ? "*":"") << "arg" << i;) );
+                        bool is_restrict = restrict_args && restrict_args->at(i);
+                        this->emit_ctype( ty, FMT_CB(os, os << (this->type_is_high_align(ty) ? "*":"") << (is_restrict ? "__restrict " : "") << "arg" << i;) );
                     }
 
                     if( item.m_variadic )
@@ -6516,73 +7196,64 @@ namespace {
             }
             // -- Platform Intrinsics --
             else if( name.compare(0, 9, "platform:") == 0 ) {
-                struct SimdInfo {
-                    unsigned count;
-                    unsigned item_size;
-                    enum Ty {
-                        Float,
-                        Signed,
-                        Unsigned,
-                    } ty;
-
-                    static SimdInfo for_ty(const CodeGenerator_C& self, const HIR::TypeRef& ty) {
-                        size_t size_slot = 0, size_val = 0;;
-                        Target_GetSizeOf(self.sp, self.m_resolve, ty, size_slot);
-                        const auto& ty_val = ty.data().as_Path().binding.as_Struct()->m_data.as_Tuple().at(0).ent;
-                        Target_GetSizeOf(self.sp, self.m_resolve, ty_val, size_val);
-
-                        MIR_ASSERT(*self.m_mir_res, size_slot >= size_val, size_slot << " < " << size_val);
-                        MIR_ASSERT(*self.m_mir_res, size_slot / size_val * size_val == size_slot, size_slot << " not a multiple of " << size_val);
-
-                        SimdInfo    rv;
-                        rv.item_size = size_val;
-                        rv.count = size_slot / size_val;
-                        switch(ty_val.data().as_Primitive())
-                        {
-                        case ::HIR::CoreType::I8:   rv.ty = Signed; break;
-                        case ::HIR::CoreType::I16:  rv.ty = Signed; break;
-                        case ::HIR::CoreType::I32:  rv.ty = Signed; break;
-                        case ::HIR::CoreType::I64:  rv.ty = Signed; break;
-                        //case ::HIR::CoreType::I128: rv.ty = Signed; break;
-                        case ::HIR::CoreType::U8:   rv.ty = Unsigned; break;
-                        case ::HIR::CoreType::U16:  rv.ty = Unsigned; break;
-                        case ::HIR::CoreType::U32:  rv.ty = Unsigned; break;
-                        case ::HIR::CoreType::U64:  rv.ty = Unsigned; break;
-                        //case ::HIR::CoreType::U128: rv.ty = Unsigned; break;
-                        case ::HIR::CoreType::F32:  rv.ty = Float;  break;
-                        case ::HIR::CoreType::F64:  rv.ty = Float;  break;
-                        default:
-                            MIR_BUG(*self.m_mir_res, "Invalid SIMD type inner - " << ty_val);
-                        }
-                        return rv;
-                    }
-                    void emit_val_ty(CodeGenerator_C& self) {
-                        switch(ty)
-                        {
-                        case Float: self.m_of << (item_size == 4 ? "float" : "double"); break;
-                        case Signed:    self.m_of << "int" << (item_size*8) << "_t";    break;
-                        case Unsigned:  self.m_of << "uint" << (item_size*8) << "_t";   break;
-                        }
-                    }
-                };
-
                 auto simd_cmp = [&](const char* op) {
                     auto src_info = SimdInfo::for_ty(*this, params.m_types.at(0));
                     auto dst_info = SimdInfo::for_ty(*this, params.m_types.at(1));
                     MIR_ASSERT(mir_res, src_info.count == dst_info.count, "Element counts must match for " << name);
+                    // NOTE: True lanes are all ones (matching rustc's sign-extended `icmp`/`fcmp` result)
+                    if( src_info.item_size == dst_info.item_size && simd_has_vector_type(params.m_types.at(0)) && simd_has_vector_type(params.m_types.at(1)) )
+                    {
+                        // Vector comparisons produce a signed lane mask of the operand's lane width
+                        emit_simd_vector_access(params.m_types.at(1), [&](){ emit_lvalue(e.ret_val); });
+                        m_of << " = (v_" << Trans_Mangle(params.m_types.at(1).data().as_Path().path.m_data.as_Generic()) << ")(";
+                        emit_simd_vector_access(params.m_types.at(0), [&](){ emit_param(e.args.at(0)); });
+                        m_of << " " << op << " ";
+                        emit_simd_vector_access(params.m_types.at(0), [&](){ emit_param(e.args.at(1)); });
+                        m_of << ")";
+                        return ;
+                    }
                     m_of << "for(int i = 0; i < " << dst_info.count << "; i++)";
                     m_of << "(("; dst_info.emit_val_ty(*this); m_of << "*)&"; emit_lvalue(e.ret_val); m_of << ")[i] ";
-                    m_of << "= (";
+                    m_of << "= -(";
                     m_of << " (("; src_info.emit_val_ty(*this); m_of << "*)&"; emit_param(e.args.at(0)); m_of << ")[i]";
                     m_of << op;
                     m_of << " (("; src_info.emit_val_ty(*this); m_of << "*)&"; emit_param(e.args.at(1)); m_of << ")[i]";
                     m_of << " )";
                     };
-                auto simd_arith = [&](const char* op) {
-                    auto info = SimdInfo::for_ty(*this, params.m_types.at(0));
+                // `wrapping` - Integer lanes wrap on overflow (add/sub/mul), so the operation is done on unsigned values
+                auto simd_arith = [&](const char* op, bool wrapping) {
+                    const auto& ty = params.m_types.at(0);
+                    auto info = SimdInfo::for_ty(*this, ty);
+                    if( simd_has_vector_type(ty) )
+                    {
+                        emit_simd_vector_access(ty, [&](){ emit_lvalue(e.ret_val); });
+                        m_of << " = ";
+                        if( wrapping && info.ty == SimdInfo::Signed )
+                        {
+                            auto mangled = Trans_Mangle(ty.data().as_Path().path.m_data.as_Generic());
+                            m_of << "(v_" << mangled << ")((vu_" << mangled << ")";
+                            emit_simd_vector_access(ty, [&](){ emit_param(e.args.at(0)); });
+                            m_of << " " << op << " (vu_" << mangled << ")";
+                            emit_simd_vector_access(ty, [&](){ emit_param(e.args.at(1)); });
+                            m_of << ")";
+                            return ;
+                        }
+                        emit_simd_vector_access(ty, [&](){ emit_param(e.args.at(0)); });
+                        m_of << " " << op << " ";
+                        emit_simd_vector_access(ty, [&](){ emit_param(e.args.at(1)); });
+                        return ;
+                    }
                     // Emulate!
                     emit_lvalue(e.ret_val); m_of << " = "; emit_param(e.args.at(0)); m_of << "; ";
                     m_of << "for(int i = 0; i < " << info.count << "; i++)";
+                    if( wrapping && info.ty != SimdInfo::Float )
+                    {
+                        m_of << "(("; info.emit_val_ty(*this); m_of << "*)&"; emit_lvalue(e.ret_val); m_of << ")[i] = ";
+                        m_of << "("; info.emit_wrapping_ty(*this); m_of << ")(("; info.emit_val_ty(*this); m_of << "*)&"; emit_lvalue(e.ret_val); m_of << ")[i]";
+                        m_of << " " << op << " ";
+                        m_of << "("; info.emit_wrapping_ty(*this); m_of << ")(("; info.emit_val_ty(*this); m_of << "*)&"; emit_param(e.args.at(1)); m_of << ")[i]";
+                        return ;
+                    }
                     m_of << "(("; info.emit_val_ty(*this); m_of << "*)&"; emit_lvalue(e.ret_val); m_of << ")[i] ";
                     m_of << op << "=";
                     m_of << " (("; info.emit_val_ty(*this); m_of << "*)&"; emit_param(e.args.at(1)); m_of << ")[i]";
@@ -6597,9 +7268,15 @@ namespace {
                     MIR_ASSERT(mir_res, size_slot >= size_val, size_slot << " < " << size_val);
                     MIR_ASSERT(mir_res, size_slot / size_val * size_val == size_slot, size_slot << " not a multiple of " << size_val);
 
-                    // Emulate!
                     emit_lvalue(e.ret_val); m_of << " = "; emit_param(e.args.at(0)); m_of << "; ";
-                    m_of << "(( "; emit_ctype(params.m_types.at(1)); m_of << "*)&"; emit_lvalue(e.ret_val); m_of << ")["; emit_param(e.args.at(1)); m_of << "] = "; emit_param(e.args.at(2));
+                    if( simd_has_vector_type(params.m_types.at(0)) ) {
+                        emit_simd_vector_access(params.m_types.at(0), [&](){ emit_lvalue(e.ret_val); });
+                        m_of << "["; emit_param(e.args.at(1)); m_of << "] = "; emit_param(e.args.at(2));
+                    }
+                    else {
+                        // Emulate!
+                        m_of << "(( "; emit_ctype(params.m_types.at(1)); m_of << "*)&"; emit_lvalue(e.ret_val); m_of << ")["; emit_param(e.args.at(1)); m_of << "] = "; emit_param(e.args.at(2));
+                    }
                 }
                 else if( name == "platform:simd_extract" ) {
                     size_t size_slot = 0, size_val = 0;
@@ -6608,39 +7285,59 @@ namespace {
                     MIR_ASSERT(mir_res, size_slot >= size_val, size_slot << " < " << size_val);
                     MIR_ASSERT(mir_res, size_slot / size_val * size_val == size_slot, size_slot << " not a multiple of " << size_val);
 
-                    // Emulate!
-                    emit_lvalue(e.ret_val); m_of << " = (( "; emit_ctype(params.m_types.at(1)); m_of << "*)&"; emit_param(e.args.at(0)); m_of << ")["; emit_param(e.args.at(1)); m_of << "]";
-                }
-                else if(
-                        name == "platform:simd_shuffle128" ||
-                        name == "platform:simd_shuffle64" ||
-                        name == "platform:simd_shuffle32" ||
-                        name == "platform:simd_shuffle16" ||
-                        name == "platform:simd_shuffle8" ||
-                        name == "platform:simd_shuffle4" ||
-                        name == "platform:simd_shuffle2"
+                    if( simd_has_vector_type(params.m_types.at(0)) ) {
+                        emit_lvalue(e.ret_val); m_of << " = ";
+                        emit_simd_vector_access(params.m_types.at(0), [&](){ emit_param(e.args.at(0)); });
+                        m_of << "["; emit_param(e.args.at(1)); m_of << "]";
+                    }
+                    else {
+                        // Emulate!
+                        emit_lvalue(e.ret_val); m_of << " = (( "; emit_ctype(params.m_types.at(1)); m_of << "*)&"; emit_param(e.args.at(0)); m_of << ")["; emit_param(e.args.at(1)); m_of << "]";
+                    }
+                }
+                // `simd_shuffle<N>`, where N is the output lane count (any count, not just powers of two)
+                else if( name.size() > 21 && strncmp(name.c_str(), "platform:simd_shuffle", 21) == 0
+                        && ::std::all_of(name.begin() + 21, name.end(), [](char c){ return isdigit(static_cast<unsigned char>(c)); })
                         ) {
-                    // Shuffle in 8 entries
                     size_t size_slot = 0;
                     Target_GetSizeOf(sp, m_resolve, params.m_types.at(1), size_slot);
-                    size_t div =
-                        name == "platform:simd_shuffle128" ? 128 :
-                        name == "platform:simd_shuffle64" ? 64 :
-                        name == "platform:simd_shuffle32" ? 32 :
-                        name == "platform:simd_shuffle16" ? 16 :
-                        name == "platform:simd_shuffle8" ? 8 :
-                        name == "platform:simd_shuffle4" ? 4 :
-                        name == "platform:simd_shuffle2" ? 2 :
-                        throw ""
-                        ;
+                    size_t div = strtoul(name.c_str() + 21, nullptr, 10);
+                    MIR_ASSERT(mir_res, div > 0, "Zero-lane shuffle " << name);
                     size_t size_val = size_slot / div;
                     MIR_ASSERT(mir_res, size_val > 0, size_slot << " / " << div << " == 0?");
                     MIR_ASSERT(mir_res, size_slot >= size_val, size_slot << " < " << size_val);
                     MIR_ASSERT(mir_res, size_slot / size_val * size_val == size_slot, size_slot << " not a multiple of " << size_val);
+                    size_t size_in = 0;
+                    Target_GetSizeOf(sp, m_resolve, params.m_types.at(0), size_in);
+                    size_t count_in = size_in / size_val;
+                    MIR_ASSERT(mir_res, count_in > 0 && count_in * size_val == size_in, size_in << " not a multiple of " << size_val);
+
+                    // Two-input shuffles with matching lane counts map onto `__builtin_shuffle` (which clang lacks, it
+                    // only has `__builtin_shufflevector` with constant indices)
+                    bool use_vector = count_in == div && simd_has_vector_type(params.m_types.at(0)) && simd_has_vector_type(params.m_types.at(1));
+                    if( use_vector ) {
+                        m_of << "\n#ifdef __clang__\n";
+                    }
                     m_of << "for(int i = 0; i < " << div << "; i++) { int j = "; emit_param(e.args.at(2)); m_of << ".DATA[i];";
                     m_of << "((uint" << (size_val*8) << "_t*)&"; emit_lvalue(e.ret_val); m_of << ")[i]";
-                    m_of << " = ((uint" << (size_val*8) << "_t*)(j < " << div << " ? &"; emit_param(e.args.at(1)); m_of << " : &"; emit_param(e.args.at(1)); m_of << "))[j % " << div << "];";
+                    m_of << " = ((uint" << (size_val*8) << "_t*)(j < " << count_in << " ? &"; emit_param(e.args.at(0)); m_of << " : &"; emit_param(e.args.at(1)); m_of << "))[j % " << count_in << "];";
                     m_of << "}";
+                    if( use_vector ) {
+                        m_of << "\n#else\n";
+                        m_of << "\t{ int" << (size_val*8) << "_t __attribute__((vector_size(" << size_slot << "))) m = {";
+                        for(size_t i = 0; i < div; i ++) {
+                            if(i > 0)   m_of << ",";
+                            m_of << " "; emit_param(e.args.at(2)); m_of << ".DATA[" << i << "]";
+                        }
+                        m_of << " }; ";
+                        emit_simd_vector_access(params.m_types.at(1), [&](){ emit_lvalue(e.ret_val); });
+                        m_of << " = (v_" << Trans_Mangle(params.m_types.at(1).data().as_Path().path.m_data.as_Generic()) << ")__builtin_shuffle(";
+                        emit_simd_vector_access(params.m_types.at(0), [&](){ emit_param(e.args.at(0)); });
+                        m_of << ", ";
+                        emit_simd_vector_access(params.m_types.at(0), [&](){ emit_param(e.args.at(1)); });
+                        m_of << ", m); }";
+                        m_of << "\n#endif\n\t";
+                    }
                 }
                 else if( name == "platform:simd_cast" ) {
                     auto src_info = SimdInfo::for_ty(*this, params.m_types.at(0));
@@ -6679,13 +7376,13 @@ namespace {
                 else if(name == "platform:simd_gt")   simd_cmp(">" );
                 else if(name == "platform:simd_ge")   simd_cmp(">=");
                 // Arithmetic
-                else if(name == "platform:simd_add")    simd_arith("+");
-                else if(name == "platform:simd_sub")    simd_arith("-");
-                else if(name == "platform:simd_mul")    simd_arith("*");
-                else if(name == "platform:simd_div")    simd_arith("/");
-                else if(name == "platform:simd_and")    simd_arith("&");
-                else if(name == "platform:simd_or" )    simd_arith("|");
-                else if(name == "platform:simd_xor")    simd_arith("^");
+                else if(name == "platform:simd_add")    simd_arith("+", true);
+                else if(name == "platform:simd_sub")    simd_arith("-", true);
+                else if(name == "platform:simd_mul")    simd_arith("*", true);
+                else if(name == "platform:simd_div")    simd_arith("/", false);
+                else if(name == "platform:simd_and")    simd_arith("&", false);
+                else if(name == "platform:simd_or" )    simd_arith("|", false);
+                else if(name == "platform:simd_xor")    simd_arith("^", false);
 
                 else {
                     // TODO: Platform intrinsics
@@ -7357,7 +8054,7 @@ namespace {
     Span CodeGenerator_C::sp;
 }
 
-::std::unique_ptr<CodeGenerator> Trans_Codegen_GetGeneratorC(const ::HIR::Crate& crate, const ::std::string& outfile)
+::std::unique_ptr<CodeGenerator> Trans_Codegen_GetGeneratorC(const ::HIR::Crate& crate, const ::std::string& outfile, const TransOptions& opt)
 {
-    return ::std::unique_ptr<CodeGenerator>(new CodeGenerator_C(crate, outfile));
+    return ::std::unique_ptr<CodeGenerator>(new CodeGenerator_C(crate, outfile, opt));
 }
@@ -25,14 +25,17 @@ namespace {
         const ::HIR::Crate& crate;
         StaticTraitResolve  resolve;
         TransList   rv;
+        /// Link to generic instances exported by upstream crates instead of generating them
+        bool    share_generics;
 
         // Queue of items to enumerate
         ::std::deque<TransList_Function*>  fcn_queue;
         ::std::vector<TransList_Function*> fcns_to_type_visit;
 
-        EnumState(const ::HIR::Crate& crate):
+        EnumState(const ::HIR::Crate& crate, bool share_generics):
             crate(crate)
             , resolve(crate)
+            , share_generics(share_generics)
         {}
 
         void enum_fcn(::HIR::Path p, const ::HIR::Function& fcn, Trans_Params pp)
@@ -42,8 +45,27 @@ namespace {
                 fcns_to_type_visit.push_back(e);
                 e->ptr = &fcn;
                 e->pp = mv$(pp);
-                fcn_queue.push_back(e);
+                // An upstream crate already emits this instance, so just reference it (and don't enumerate its body)
+                if( share_generics && e->pp.has_types() && is_upstream_monomorph(*e->path) )
+                {
+                    DEBUG("Upstream instance " << *e->path);
+                    e->force_prototype = true;
+                }
+                else
+                {
+                    fcn_queue.push_back(e);
+                }
+            }
+        }
+
+        bool is_upstream_monomorph(const ::HIR::Path& p) const
+        {
+            for(const auto& ec : crate.m_ext_crates)
+            {
+                if( ec.second.m_data->m_exported_monomorphs.count(p) > 0 )
+                    return true;
             }
+            return false;
         }
     };
 }
@@ -103,11 +125,11 @@ namespace MIR {
 }
 
 /// Enumerate trans items starting from `::main` (binary crate)
-TransList Trans_Enumerate_Main(const ::HIR::Crate& crate)
+TransList Trans_Enumerate_Main(const ::HIR::Crate& crate, bool share_generics)
 {
     static Span sp;
 
-    EnumState   state { crate };
+    EnumState   state { crate, share_generics };
 
     auto c_start_path = crate.get_lang_item_path_opt("mrustc-start");
     if( c_start_path == ::HIR::SimplePath() )
@@ -282,10 +304,10 @@ namespace {
 }
 
 /// Enumerate trans items for all public non-generic items (library crate)
-TransList Trans_Enumerate_Public(::HIR::Crate& crate)
+TransList Trans_Enumerate_Public(::HIR::Crate& crate, bool share_generics)
 {
     static Span sp;
-    EnumState   state { crate };
+    EnumState   state { crate, share_generics };
 
     Trans_Enumerate_Public_Mod(state, crate.m_root_module,  ::HIR::SimplePath(crate.m_crate_name,{}), true);
 
@@ -301,9 +323,12 @@ TransList Trans_Enumerate_Public(::HIR::Crate& crate)
                 Trans_Enumerate_Public_TraitImpl(state, resolve, trait_path, *impl);
             }
         }
-        for(auto& impl : impl_group.second.non_named)
+        for(auto& impl_list : impl_group.second.non_named)
         {
-            Trans_Enumerate_Public_TraitImpl(state, resolve, trait_path, *impl);
+            for(auto& impl : impl_list.second)
+            {
+                Trans_Enumerate_Public_TraitImpl(state, resolve, trait_path, *impl);
+            }
         }
         for(auto& impl : impl_group.second.generic)
         {
@@ -347,9 +372,12 @@ TransList Trans_Enumerate_Public(::HIR::Crate& crate)
             H1::enumerate_type_impl(state, *impl);
         }
     }
-    for(auto& impl : crate.m_type_impls.non_named)
+    for(auto& impl_grp : crate.m_type_impls.non_named)
     {
-        H1::enumerate_type_impl(state, *impl);
+        for(auto& impl : impl_grp.second)
+        {
+            H1::enumerate_type_impl(state, *impl);
+        }
     }
     for(auto& impl : crate.m_type_impls.generic)
     {
@@ -380,12 +408,28 @@ TransList Trans_Enumerate_Public(::HIR::Crate& crate)
     return rv;
 }
 
+void Trans_Enumerate_RecordExports(::HIR::Crate& crate, const TransList& list)
+{
+    crate.m_exported_monomorphs.clear();
+    for(const auto& ent : list.m_functions)
+    {
+        const auto& fcn = *ent.second->ptr;
+        // Only instances of this crate's own generics get external linkage (codegen makes copies of generics from
+        // other crates local to the object, as the same instance can be generated by several sibling crates)
+        if( ent.second->pp.has_types() && fcn.m_code && fcn.m_code.m_mir && !ent.second->force_prototype )
+        {
+            crate.m_exported_monomorphs.insert(ent.first.clone());
+        }
+    }
+    DEBUG(crate.m_exported_monomorphs.size() << " exported generic instances");
+}
+
 void Trans_Enumerate_Cleanup(const ::HIR::Crate& crate, TransList& list)
 {
     // NOTE: Disabled, as full filtering is nigh-on impossible
     // - Could do partial filtering of unused locally generated versions of trait impls and inlines
 #if 0
-    EnumState   state { crate };
+    EnumState   state { crate, false };
 
 
     // Visit every function used and determine the items it uses
@@ -731,11 +775,13 @@ namespace
                 }
             }
             auto i = out_list.size();
-            out_list.push_back( ::std::make_pair(ty.clone(), shallow) );
+            // Interned, as these are used as keys for type reprs and are compared/hashed repeatedly during codegen
+            out_list.push_back( ::std::make_pair(::HIR::TypeRef::new_interned(ty), shallow) );
             DEBUG("Add type " << ty << (shallow ? " (Shallow)": "") << " " << i);
         }
 
-        void __attribute__ ((noinline)) visit_function(const ::HIR::Path& path, const ::HIR::Function& fcn, const Trans_Params& pp)
+        /// Visit the types used by a function (just the signature if `sig_only` is set)
+        void __attribute__ ((noinline)) visit_function(const ::HIR::Path& path, const ::HIR::Function& fcn, const Trans_Params& pp, bool sig_only)
         {
             Span    sp;
             auto& tv = *this;
@@ -776,7 +822,7 @@ namespace
             for(const auto& arg : fcn.m_args)
                 tv.visit_type( monomorph(arg.second) );
 
-            if( fcn.m_code.m_mir )
+            if( fcn.m_code.m_mir && !sig_only )
             {
                 const auto& mir = *fcn.m_code.m_mir;
                 for(const auto& ty : mir.locals)
@@ -917,7 +963,8 @@ void Trans_Enumerate_Types(EnumState& state)
             const auto& pp = p->pp;
 
             TRACE_FUNCTION_F("Function " << fcn_path);
-            tv.visit_function(fcn_path, fcn, pp);
+            // Functions that are only prototyped don't need the types used in their body
+            tv.visit_function(fcn_path, fcn, pp, /*sig_only=*/p->force_prototype);
         }
         state.fcns_to_type_visit.clear();
         // TODO: Similarly restrict revisiting of statics.
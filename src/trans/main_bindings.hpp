@@ -19,6 +19,27 @@ struct TransOptions
     unsigned int opt_level = 0;
     bool emit_debug_info = false;
     ::std::string   build_command_file;
+    /// Number of C files to split function bodies across (compiled in parallel)
+    unsigned int codegen_units = 1;
+    /// Directory for the incremental codegen cache (`-C incremental`), empty if disabled
+    /// - Function bodies are assigned to units by a hash of their name, and a unit is only recompiled if
+    ///   its generated C (or the shared header, the C compiler's version, or the compiler flags) changed since the
+    ///   last build.
+    /// - Only useful with several codegen units. If `-C codegen-units` isn't given, 16 are used (with a note).
+    /// - Only the C compiler's objects are reused: every compiler pass (including MIR generation and C
+    ///   generation) still runs on the whole crate, there are no per-item fingerprints or cached MIR.
+    ::std::string   incremental_dir;
+    /// Pass aliasing information from borrow types to the C compiler (`-C noalias`)
+    /// - Reference arguments get `nonnull`, and `&mut T`/`&T` (to non-interior-mutable data) arguments get `restrict`
+    bool emit_noalias = false;
+    /// Link-time optimisation (`-C lto`)
+    /// - Library objects hold both the compiler's IR and regular code, so they can still be linked without LTO
+    bool lto = false;
+    /// Directory to write profile data to from an instrumented build (`-C profile-generate`), empty if disabled
+    ::std::string   profile_generate_dir;
+    /// Directory to read profile data from (`-C profile-use`), empty if disabled
+    /// - The profiled build must have used the same output paths, as the data is keyed by object path
+    ::std::string   profile_use_dir;
 
     ::std::string   panic_crate;
 
@@ -33,9 +54,12 @@ enum class CodegenOutput {
     Executable, // no suffix, includes main stub (TODO: Can't that just be added earlier?)
 };
 
-extern TransList Trans_Enumerate_Main(const ::HIR::Crate& crate);
+// NOTE: If `share_generics` is set, generic instances exported by loaded crates are only prototyped
+extern TransList Trans_Enumerate_Main(const ::HIR::Crate& crate, bool share_generics);
 // NOTE: This also sets the saveout flags
-extern TransList Trans_Enumerate_Public(::HIR::Crate& crate);
+extern TransList Trans_Enumerate_Public(::HIR::Crate& crate, bool share_generics);
+/// Record the generic instances that codegen will emit with external linkage (saved in the .hir for downstream crates)
+extern void Trans_Enumerate_RecordExports(::HIR::Crate& crate, const TransList& list);
 
 /// Re-run enumeration on monomorphised functions, removing now-unused items
 extern void Trans_Enumerate_Cleanup(const ::HIR::Crate& crate, TransList& list);
@@ -481,6 +481,9 @@ void Trans_Monomorphise_List(const ::HIR::Crate& crate, TransList& list)
     for(auto& fcn_ent : list.m_functions)
     {
         const auto& fcn = *fcn_ent.second->ptr;
+        // Only a prototype is emitted (e.g. the instance is provided by an upstream crate)
+        if( fcn_ent.second->force_prototype )
+            continue ;
         // Trait methods (which are the only case where `Self` can exist in the argument list at this stage) always need to be monomorphised.
         bool is_method = ( fcn.m_args.size() > 0 && visit_ty_with(fcn.m_args[0].second, [&](const auto& x){return x == ::HIR::TypeRef("Self",0xFFFF);}) );
         if(fcn_ent.second->pp.has_types() || is_method)
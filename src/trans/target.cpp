@@ -10,6 +10,8 @@
 #include "../expand/cfg.hpp"
 #include <fstream>
 #include <map>
+#include <unordered_map>
+#include <mutex>
 #include <hir/hir.hpp>
 #include <hir_typeck/helpers.hpp>
 #include <hir_conv/main_bindings.hpp>   // ConvertHIR_ConstantEvaluate_Enum
@@ -1957,25 +1959,29 @@ namespace {
         return rv;
     }
 
-    // TODO: Thread safety on this cache?
-    static ::std::map<::HIR::TypeRef, ::std::unique_ptr<TypeRepr>>  s_cache;
+    // Keys are interned where possible, so lookups of already-seen types are cheap
+    static ::std::unordered_map<::HIR::TypeRef, ::std::unique_ptr<TypeRepr>, ::std::hash<::HIR::TypeRef>, ::HIR::TypeRefOrdEqual>  s_cache;
+    // Recursive, as creating a repr can request (or set) the repr of inner types
+    static ::std::recursive_mutex   s_cache_lock;
 
     void set_type_repr(const Span& sp, const ::HIR::TypeRef& ty, ::std::unique_ptr<TypeRepr> repr)
     {
-        auto ires = s_cache.insert(::std::make_pair( ty.clone(), mv$(repr) ));
+        ::std::lock_guard<::std::recursive_mutex>   _lh(s_cache_lock);
+        auto ires = s_cache.insert(::std::make_pair( ::HIR::TypeRef::new_interned(ty), mv$(repr) ));
         ASSERT_BUG(sp, ires.second, "set_type_repr called for type that already has a repr: " << ty);
         DEBUG("Set repr for " << ires.first->first);
     }
 }
 const TypeRepr* Target_GetTypeRepr(const Span& sp, const StaticTraitResolve& resolve, const ::HIR::TypeRef& ty)
 {
+    ::std::lock_guard<::std::recursive_mutex>   _lh(s_cache_lock);
     auto it = s_cache.find(ty);
     if( it != s_cache.end() )
     {
         return it->second.get();
     }
 
-    auto ires = s_cache.insert(::std::make_pair( ty.clone(), make_type_repr(sp, resolve, ty) ));
+    auto ires = s_cache.insert(::std::make_pair( ::HIR::TypeRef::new_interned(ty), make_type_repr(sp, resolve, ty) ));
     if(ires.second)
     {
         DEBUG("Created repr for " << ires.first->first);
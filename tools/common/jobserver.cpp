@@ -0,0 +1,247 @@
+/*
+ * mrustc common code
+ * - by John Hodge (Mutabah)
+ *
+ * tools/common/jobserver.cpp
+ * - GNU make compatible jobserver
+ */
+#ifdef _MSC_VER
+# define _CRT_SECURE_NO_WARNINGS    // getenv
+#endif
+#include "jobserver.h"
+#include <cstdlib>  // getenv, setenv
+#include <cstring>
+#include <sstream>
+#ifndef _WIN32
+# include <mutex>
+# include <unistd.h>
+# include <fcntl.h>
+# include <errno.h>
+# include <sys/stat.h>
+#endif
+
+namespace {
+#ifndef _WIN32
+    struct JobServerState
+    {
+        int read_fd = -1;
+        int write_fd = -1;
+
+        ::std::mutex    lock;
+        bool    implicit_free = true;
+        /// The implicit slot was handed to the pipe (see `release_implicit`), reclaim it from the next pipe
+        /// token released by this process
+        bool    implicit_donated = false;
+        /// Number of threads blocked reading a token from the pipe
+        unsigned    num_waiters = 0;
+
+        /// Give up the implicit slot (must be called with `lock` held)
+        void release_implicit()
+        {
+            if( num_waiters > 0 )
+            {
+                // A thread in this process is blocked in `read`, which can't be interrupted. Hand the slot over
+                // by writing a token for it, and take the slot back when a pipe token is next released.
+                char c = '+';
+                while( write(write_fd, &c, 1) < 0 && errno == EINTR )
+                    ;
+                implicit_donated = true;
+            }
+            else
+            {
+                implicit_free = true;
+            }
+        }
+    };
+    JobServerState  s_state;
+
+    /// Check that `fd` is open and refers to a pipe (the fd numbers in `MAKEFLAGS` may have been
+    /// closed by the parent, and then reused for something else)
+    bool is_open_pipe(int fd)
+    {
+        struct stat s;
+        if( fd < 0 || fcntl(fd, F_GETFD) == -1 )
+            return false;
+        if( fstat(fd, &s) != 0 )
+            return false;
+        return S_ISFIFO(s.st_mode);
+    }
+#endif
+}
+
+bool JobServer::create(unsigned num_jobs)
+{
+#ifdef _WIN32
+    return false;
+#else
+    if( num_jobs == 0 )
+        return false;
+    int fds[2];
+    // NOTE: No `O_CLOEXEC`, the whole point is for child processes to inherit these
+    if( pipe(fds) != 0 )
+        return false;
+    // One token per slot, except the implicit slot this process holds
+    for(unsigned i = 1; i < num_jobs; i ++)
+    {
+        char c = '+';
+        if( write(fds[1], &c, 1) != 1 )
+        {
+            close(fds[0]);
+            close(fds[1]);
+            return false;
+        }
+    }
+    s_state.read_fd = fds[0];
+    s_state.write_fd = fds[1];
+
+    // Both the current (`--jobserver-auth`) and pre-4.2 (`--jobserver-fds`) forms, so any version of
+    // make (or gcc's `-flto=jobserver`) can pick it up
+    ::std::stringstream ss;
+    ss << " -j" << num_jobs
+        << " --jobserver-fds=" << fds[0] << "," << fds[1]
+        << " --jobserver-auth=" << fds[0] << "," << fds[1];
+    setenv("MAKEFLAGS", ss.str().c_str(), /*overwrite=*/1);
+    unsetenv("MFLAGS");
+    return true;
+#endif
+}
+
+bool JobServer::attach_from_env()
+{
+#ifdef _WIN32
+    return false;
+#else
+    const char* flags = getenv("MAKEFLAGS");
+    if( !flags )
+        return false;
+    ::std::string   s = flags;
+
+    // If both forms are present, use the last one (matching make's own parsing)
+    size_t pos = ::std::string::npos;
+    for(const char* opt : { "--jobserver-fds=", "--jobserver-auth=" })
+    {
+        auto p = s.rfind(opt);
+        if( p != ::std::string::npos && (pos == ::std::string::npos || p > pos) )
+            pos = p + strlen(opt);
+    }
+    if( pos == ::std::string::npos )
+        return false;
+    auto end = s.find(' ', pos);
+    auto val = s.substr(pos, end == ::std::string::npos ? ::std::string::npos : end - pos);
+
+    int rfd, wfd;
+    if( val.compare(0, 5, "fifo:") == 0 )
+    {
+        // make 4.4+ named pipe form
+        rfd = open(val.c_str() + 5, O_RDWR|O_CLOEXEC);
+        if( rfd < 0 )
+            return false;
+        wfd = rfd;
+    }
+    else
+    {
+        char* ep;
+        rfd = static_cast<int>(strtol(val.c_str(), &ep, 10));
+        if( *ep != ',' )
+            return false;
+        wfd = static_cast<int>(strtol(ep + 1, &ep, 10));
+        if( !is_open_pipe(rfd) || !is_open_pipe(wfd) )
+            return false;
+    }
+    s_state.read_fd = rfd;
+    s_state.write_fd = wfd;
+    return true;
+#endif
+}
+
+bool JobServer::is_active()
+{
+#ifdef _WIN32
+    return false;
+#else
+    return s_state.read_fd >= 0;
+#endif
+}
+
+JobServer::Token::Token():
+    m_state(State::None),
+    m_byte(0)
+{
+#ifndef _WIN32
+    if( !JobServer::is_active() )
+        return ;
+    {
+        ::std::lock_guard<::std::mutex> lh { s_state.lock };
+        if( s_state.implicit_free )
+        {
+            s_state.implicit_free = false;
+            m_state = State::Implicit;
+            return ;
+        }
+        s_state.num_waiters += 1;
+    }
+    for(;;)
+    {
+        auto rv = read(s_state.read_fd, &m_byte, 1);
+        if( rv < 0 && errno == EINTR )
+            continue ;
+        // If the jobserver has gone away (or is broken), run without a token rather than failing the build
+        if( rv == 1 )
+            m_state = State::Pipe;
+        break;
+    }
+    ::std::lock_guard<::std::mutex> lh { s_state.lock };
+    s_state.num_waiters -= 1;
+#endif
+}
+JobServer::Token::Token(Token&& x):
+    m_state(x.m_state),
+    m_byte(x.m_byte)
+{
+    x.m_state = State::None;
+}
+JobServer::Token& JobServer::Token::operator=(Token&& x)
+{
+    if( this != &x )
+    {
+        release();
+        m_state = x.m_state;
+        m_byte = x.m_byte;
+        x.m_state = State::None;
+    }
+    return *this;
+}
+JobServer::Token::~Token()
+{
+    release();
+}
+void JobServer::Token::release()
+{
+#ifndef _WIN32
+    switch(m_state)
+    {
+    case State::None:
+        break;
+    case State::Implicit: {
+        ::std::lock_guard<::std::mutex> lh { s_state.lock };
+        s_state.release_implicit();
+        } break;
+    case State::Pipe: {
+        ::std::lock_guard<::std::mutex> lh { s_state.lock };
+        if( s_state.implicit_donated )
+        {
+            // Keep this token in place of the one written for the implicit slot
+            s_state.implicit_donated = false;
+            s_state.release_implicit();
+        }
+        else
+        {
+            // Write back the same byte (make can use the token value to signal failure)
+            while( write(s_state.write_fd, &m_byte, 1) < 0 && errno == EINTR )
+                ;
+        }
+        } break;
+    }
+#endif
+    m_state = State::None;
+}
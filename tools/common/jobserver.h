@@ -0,0 +1,53 @@
+/*
+ * mrustc common code
+ * - by John Hodge (Mutabah)
+ *
+ * tools/common/jobserver.h
+ * - GNU make compatible jobserver (HEADER)
+ */
+#pragma once
+
+#include <string>
+
+/// Process-wide GNU make compatible jobserver
+///
+/// A jobserver is a pipe pre-filled with one token byte per job slot (less the one implicitly held by
+/// the process that started the build). Any process with the pipe open (advertised to children via
+/// `MAKEFLAGS`) reads a token before starting an extra job, and writes it back once the job is done.
+/// This lets `minicargo`, each `mrustc` it runs, and the C compiler share one global job budget.
+///
+/// NOTE: Not supported on Windows (where make uses a named semaphore), all operations are no-ops.
+class JobServer
+{
+public:
+    /// Create a new jobserver with `num_jobs` slots, and export it through `MAKEFLAGS` so child
+    /// processes (and their children) can use it.
+    static bool create(unsigned num_jobs);
+    /// Attach to a jobserver advertised in `MAKEFLAGS` (by `minicargo` or `make`)
+    static bool attach_from_env();
+    /// Returns true if `create` or `attach_from_env` succeeded, otherwise tokens don't limit anything
+    static bool is_active();
+
+    /// A job slot, acquired on construction (blocking until one is avaliable) and released on destruction
+    ///
+    /// The first token in a process is the implicit slot (owned by the process itself, and not present
+    /// in the pipe), so a process with one job running never waits.
+    class Token
+    {
+        enum class State {
+            None,   // Not holding anything (moved-from, or jobserver not active)
+            Implicit,
+            Pipe,
+        } m_state;
+        char    m_byte;
+    public:
+        Token();
+        Token(const Token&) = delete;
+        Token& operator=(const Token&) = delete;
+        Token(Token&& x);
+        Token& operator=(Token&& x);
+        ~Token();
+    private:
+        void release();
+    };
+};
@@ -66,9 +66,12 @@ namespace {
                 cb(*impl);
             }
         }
-        for(const auto& impl : ig.non_named)
+        for(const auto& unnamed_il : ig.non_named)
         {
-            cb(*impl);
+            for(const auto& impl : unnamed_il.second)
+            {
+                cb(*impl);
+            }
         }
         for(const auto& impl : ig.generic)
         {
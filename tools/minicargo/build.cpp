@@ -22,6 +22,7 @@ extern int _putenv_s(const char*, const char*);
 #include "build.h"
 #include "debug.h"
 #include "stringlist.h"
+#include <jobserver.h>
 #include <vector>
 #include <algorithm>
 #include <sstream>  // stringstream
@@ -35,6 +36,8 @@ extern int _putenv_s(const char*, const char*);
 #include <fstream>
 #include <climits>
 #include <cassert>
+#include <chrono>
+#include <map>
 #ifdef _WIN32
 # include <Windows.h>
 #else
@@ -45,6 +48,7 @@ extern int _putenv_s(const char*, const char*);
 # include <sys/wait.h>
 # include <fcntl.h>
 # include <limits.h> // PATH_MAX
+# include <dirent.h>
 #endif
 #ifdef __APPLE__
 # include <mach-o/dyld.h>
@@ -103,6 +107,27 @@ namespace {
 #include <target_detect.h>	// tools/common/target_detect.h
 #define HOST_TARGET	DEFAULT_TARGET_NAME
 
+/// Per-crate compile durations (in milliseconds) from previous builds, stored in the output directory
+///
+/// Used to estimate how long each crate's chain of dependents will take, so the crates that
+/// gate the most work (e.g. `std`, `syntax`) are started first.
+class BuildTimes
+{
+    ::helpers::path m_path;
+#ifndef DISABLE_MULTITHREAD
+    mutable ::std::mutex    m_lock;
+#endif
+    ::std::map<::std::string, unsigned long>    m_times;
+    bool    m_changed;
+public:
+    BuildTimes(::helpers::path path);
+
+    /// Returns the last recorded duration, or zero if the crate hasn't been built before
+    unsigned long get(const ::std::string& key) const;
+    void record(const ::std::string& key, unsigned long duration_ms);
+    void save() const;
+};
+
 /// Class abstracting access to the compiler
 class Builder
 {
@@ -110,9 +135,14 @@ class Builder
     ::helpers::path m_compiler_path;
     size_t m_total_targets;
     mutable size_t m_targets_built;
+    mutable BuildTimes  m_build_times;
 
 public:
     Builder(const BuildOptions& opts, size_t total_targets);
+    ~Builder();
+
+    /// Compile time of this crate's library in the previous build (zero if unknown)
+    unsigned long get_last_build_time(const PackageManifest& manifest, bool is_for_host) const;
 
     bool build_target(const PackageManifest& manifest, const PackageTarget& target, bool is_for_host, size_t index) const;
     bool build_library(const PackageManifest& manifest, bool is_for_host, size_t index) const;
@@ -120,9 +150,10 @@ public:
 
 private:
     ::std::string get_crate_suffix(const PackageManifest& manifest) const;
+    ::std::string get_build_time_key(const PackageManifest& manifest, bool is_for_host) const;
     ::std::string get_build_script_out(const PackageManifest& manifest) const;
     ::helpers::path get_crate_path(const PackageManifest& manifest, const PackageTarget& target, bool is_for_host, const char** crate_type, ::std::string* out_crate_suffix) const;
-    bool spawn_process_mrustc(const StringList& args, StringListKV env, const ::helpers::path& logfile) const;
+    bool spawn_process_mrustc(const StringList& args, const StringListKV& env, const ::helpers::path& logfile) const;
 
     ::helpers::path build_and_run_script(const PackageManifest& manifest, bool is_for_host) const;
 
@@ -155,6 +186,7 @@ class Timestamp
 
 public:
     static Timestamp for_file(const ::helpers::path& p);
+    static Timestamp now();
     static Timestamp infinite_past() {
 #if _WIN32
         return Timestamp { FILETIME { 0, 0 } };
@@ -320,6 +352,8 @@ bool BuildList::build(BuildOptions opts, unsigned num_jobs)
     {
         ::std::vector<unsigned> num_deps_remaining;
         ::std::vector<unsigned> build_queue;
+        /// Estimated time from starting each package until all of its dependents are built (the critical path)
+        ::std::vector<unsigned long>    priority;
 
         int complete_package(unsigned index, const ::std::vector<Entry>& list)
         {
@@ -341,11 +375,18 @@ bool BuildList::build(BuildOptions opts, unsigned num_jobs)
             return rv;
         }
 
+        /// Take the ready package with the longest critical path (the most recently queued if equal)
         unsigned get_next()
         {
             assert(!this->build_queue.empty());
-            unsigned rv = this->build_queue.back();
-            this->build_queue.pop_back();
+            size_t best = this->build_queue.size() - 1;
+            for(size_t i = best; i --; )
+            {
+                if( this->priority[this->build_queue[i]] > this->priority[this->build_queue[best]] )
+                    best = i;
+            }
+            unsigned rv = this->build_queue[best];
+            this->build_queue.erase(this->build_queue.begin() + best);
             return rv;
         }
     };
@@ -381,10 +422,53 @@ bool BuildList::build(BuildOptions opts, unsigned num_jobs)
         state.num_deps_remaining.push_back( n_deps );
     }
 
+    // Calculate the critical path length of each package, using the durations from the last build.
+    // - Packages not built before are assumed to take the average time (or all count as one unit if nothing is known)
+    {
+        ::std::vector<unsigned long>    durations;
+        durations.reserve(m_list.size());
+        unsigned long total = 0;
+        unsigned n_known = 0;
+        for(const auto& e : m_list)
+        {
+            auto d = builder.get_last_build_time(*e.package, e.is_host);
+            durations.push_back(d);
+            if( d > 0 ) {
+                total += d;
+                n_known += 1;
+            }
+        }
+        unsigned long default_duration = (n_known > 0 ? total / n_known : 1);
+
+        // The list is sorted by build order, so all dependents come after the package
+        state.priority.resize(m_list.size());
+        for(size_t i = m_list.size(); i --; )
+        {
+            unsigned long longest_dependent = 0;
+            for(auto d : m_list[i].dependents)
+                longest_dependent = ::std::max(longest_dependent, state.priority[d]);
+            state.priority[i] = (durations[i] > 0 ? durations[i] : default_duration) + longest_dependent;
+            DEBUG("Package '" << m_list[i].package->name() << "' critical path " << state.priority[i] << "ms");
+        }
+    }
+
     // Actually do the build
     if( num_jobs > 1 )
     {
 #ifndef DISABLE_MULTITHREAD
+        // Share the job budget with the processes this spawns (`mrustc` compiling C in parallel, and build
+        // scripts running `make`/`cc`), instead of each one picking its own parallelism.
+        // - Each crate build holds a token, and the child uses that token as its implicit slot.
+        // - If started by `make -jN` (e.g. `minicargo.mk`), join its jobserver instead so the whole build shares
+        //   make's budget (otherwise there would be N jobs from make plus `num_jobs` from here).
+        if( JobServer::attach_from_env() )
+        {
+            DEBUG("Using the jobserver from MAKEFLAGS");
+        }
+        else if( !JobServer::create(num_jobs) )
+        {
+            DEBUG("Unable to create jobserver, child processes won't be limited");
+        }
         class Semaphore
         {
             ::std::mutex    mutex;
@@ -464,7 +548,12 @@ bool BuildList::build(BuildOptions opts, unsigned num_jobs)
                         }
 
                         DEBUG("Thread " << my_idx << ": Starting " << cur << " - " << list[cur].package->name());
-                        if( ! builder->build_library(*list[cur].package, list[cur].is_host, cur) )
+                        bool ok;
+                        {
+                            JobServer::Token    token;
+                            ok = builder->build_library(*list[cur].package, list[cur].is_host, cur);
+                        }
+                        if( !ok )
                         {
                             queue.failure = true;
                             queue.signal_all();
@@ -611,10 +700,26 @@ bool BuildList::build(BuildOptions opts, unsigned num_jobs)
 Builder::Builder(const BuildOptions& opts, size_t total_targets):
     m_opts(opts),
     m_total_targets(total_targets),
-    m_targets_built(0)
+    m_targets_built(0),
+    m_build_times(opts.output_dir / "build_times.txt")
 {
     m_compiler_path = get_mrustc_path();
 }
+Builder::~Builder()
+{
+    m_build_times.save();
+}
+
+unsigned long Builder::get_last_build_time(const PackageManifest& manifest, bool is_for_host) const
+{
+    return m_build_times.get(this->get_build_time_key(manifest, is_for_host));
+}
+::std::string Builder::get_build_time_key(const PackageManifest& manifest, bool is_for_host) const
+{
+    // Host builds only go to a different directory when cross compiling
+    bool is_host_dir = is_for_host && m_opts.target_name != nullptr;
+    return ::format(manifest.name(), get_crate_suffix(manifest), is_host_dir ? "-host" : "");
+}
 
 ::std::string Builder::get_crate_suffix(const PackageManifest& manifest) const
 {
@@ -828,6 +933,236 @@ namespace {
     }
 }
 
+namespace {
+    /// FNV-1a, used for the rebuild fingerprints (doesn't need to be cryptographic, just stable)
+    uint64_t hash_bytes(uint64_t h, const void* data, size_t len)
+    {
+        const auto* p = static_cast<const unsigned char*>(data);
+        for(size_t i = 0; i < len; i ++)
+        {
+            h ^= p[i];
+            h *= 0x100000001b3ull;
+        }
+        return h;
+    }
+    uint64_t hash_string(uint64_t h, const char* s)
+    {
+        // Include the terminator, so adjacent strings can't run together
+        return hash_bytes(h, s, strlen(s) + 1);
+    }
+    uint64_t hash_file_contents(uint64_t h, const helpers::path& path)
+    {
+        ::std::ifstream is(path.str(), ::std::ios::binary);
+        if( !is.good() )
+        {
+            // Missing file, mix in a marker so it differs from an empty file
+            return hash_string(h, "\x01<missing>");
+        }
+        char    buf[64*1024];
+        do {
+            is.read(buf, sizeof(buf));
+            h = hash_bytes(h, buf, static_cast<size_t>(is.gcount()));
+        } while( is.good() );
+        return h;
+    }
+
+    /// Content hashes of the files read for fingerprints, so each file is only read once per run (instead of
+    /// re-reading e.g. `libstd`'s metadata for every crate that depends on it)
+    /// - Entries are checked against the file's modification time, and a crate's outputs are invalidated when
+    ///   it's rebuilt (as the timestamp resolution can be coarse).
+    class FileHashCache
+    {
+        struct Entry {
+            Timestamp   mtime;
+            uint64_t    hash;
+        };
+#ifndef DISABLE_MULTITHREAD
+        ::std::mutex    m_lock;
+#endif
+        ::std::map<::std::string, Entry>    m_entries;
+    public:
+        /// Get the hash of a file's content, returns `false` if the file doesn't exist
+        bool get(const helpers::path& path, uint64_t& out_hash)
+        {
+            auto mtime = Timestamp::for_file(path);
+            if( mtime == Timestamp::infinite_past() )
+                return false;
+            {
+#ifndef DISABLE_MULTITHREAD
+                ::std::lock_guard<::std::mutex> lh { m_lock };
+#endif
+                auto it = m_entries.find(path.str());
+                if( it != m_entries.end() && it->second.mtime == mtime )
+                {
+                    out_hash = it->second.hash;
+                    return true;
+                }
+            }
+            out_hash = hash_file_contents(0xcbf29ce484222325ull, path);
+            {
+#ifndef DISABLE_MULTITHREAD
+                ::std::lock_guard<::std::mutex> lh { m_lock };
+#endif
+                m_entries.erase(path.str());
+                m_entries.insert(::std::make_pair(path.str(), Entry { mtime, out_hash }));
+            }
+            return true;
+        }
+        void invalidate(const helpers::path& path)
+        {
+#ifndef DISABLE_MULTITHREAD
+            ::std::lock_guard<::std::mutex> lh { m_lock };
+#endif
+            m_entries.erase(path.str());
+        }
+    };
+    FileHashCache   s_file_hashes;
+
+    /// Hashes of a build's inputs, by path
+    typedef ::std::map<::std::string, uint64_t> InputHashes;
+
+    /// Get the names of the files in a directory (sorted, empty if the directory doesn't exist)
+    ::std::vector<::std::string> list_directory(const helpers::path& dir)
+    {
+        ::std::vector<::std::string>    rv;
+#if _WIN32
+        WIN32_FIND_DATA find_data;
+        HANDLE find_handle = FindFirstFile( (dir / "*").str().c_str(), &find_data );
+        if( find_handle != INVALID_HANDLE_VALUE )
+        {
+            do
+            {
+                if( !(find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) )
+                    rv.push_back(find_data.cFileName);
+            } while( FindNextFile(find_handle, &find_data) );
+            FindClose(find_handle);
+        }
+#else
+        if( auto* dp = opendir(dir.str().c_str()) )
+        {
+            while( const auto* dent = readdir(dp) )
+            {
+                if( dent->d_name[0] != '.' )
+                    rv.push_back(dent->d_name);
+            }
+            closedir(dp);
+        }
+#endif
+        ::std::sort(rv.begin(), rv.end());
+        return rv;
+    }
+
+    /// Calculate the fingerprint of a compiler invocation
+    ///
+    /// Covers the compiler executable's content, the arguments and environment, and the content of every
+    /// input listed in the depfile (source files, and the metadata of dependency crates - so a dependent
+    /// isn't rebuilt if a dependency was rebuilt without changing its metadata).
+    /// If `is_linked` (executables, build scripts), the dependencies' object code is included too.
+    /// If the build reads profile data (`-C profile-use=<dir>`), the content of that directory is included, so
+    /// a new profile rebuilds the crates that use it.
+    ///
+    /// Files already in `input_hashes` use the recorded hash, and any other file hashed is added to it. This is
+    /// called before a build (recording the inputs from the previous depfile), and again after it with the same
+    /// `input_hashes` and `build_start` set, so the saved fingerprint is of the inputs as they were when the
+    /// build started. Only the list of files comes from the new depfile; if a newly listed input was modified
+    /// after the build started, an empty fingerprint is returned (as what the compiler read isn't known).
+    ::std::string calculate_fingerprint(const helpers::path& compiler_path, const StringList& args, const StringListKV& env, const helpers::path& outfile, const helpers::path& depfile, bool is_linked,
+        InputHashes& input_hashes, const Timestamp* build_start=nullptr)
+    {
+        uint64_t h = 0xcbf29ce484222325ull;
+        if( !getenv("MINICARGO_IGNTOOLS") )
+        {
+            // The compiler is the same for the whole run, so only hash it once
+            static const uint64_t compiler_hash = hash_file_contents(0xcbf29ce484222325ull, compiler_path);
+            h = hash_bytes(h, &compiler_hash, sizeof(compiler_hash));
+        }
+        for(const char* a : args.get_vec())
+        {
+            h = hash_string(h, a);
+            if( strncmp(a, "profile-use=", 12) == 0 )
+            {
+                // NOTE: The profile isn't an input in the depfile, and is only read (never written) by this build
+                helpers::path   profile_dir = a + 12;
+                for(const auto& name : list_directory(profile_dir))
+                {
+                    uint64_t    fh = 0;
+                    s_file_hashes.get(profile_dir / name.c_str(), fh);
+                    h = hash_string(h, name.c_str());
+                    h = hash_bytes(h, &fh, sizeof(fh));
+                }
+            }
+        }
+        h = hash_string(h, "");
+        for(auto kv : env)
+        {
+            h = hash_string(h, kv.first);
+            h = hash_string(h, kv.second);
+        }
+        h = hash_string(h, "");
+
+        auto depfile_ents = load_depfile(depfile);
+        auto it = depfile_ents.find(outfile);
+        if( it == depfile_ents.end() )
+        {
+            // No record of the inputs, so it can't be known to be up to date
+            return "";
+        }
+        auto add_file = [&](const helpers::path& f)->bool {
+            uint64_t    fh;
+            auto hit = input_hashes.find(f.str());
+            if( hit != input_hashes.end() )
+            {
+                fh = hit->second;
+            }
+            else
+            {
+                if( build_start && *build_start < Timestamp::for_file(f) )
+                {
+                    DEBUG(f << " changed during the build of " << outfile);
+                    return false;
+                }
+                // Missing file, use a marker so it differs from an empty file
+                if( !s_file_hashes.get(f, fh) )
+                    fh = 0;
+                input_hashes.insert(::std::make_pair(f.str(), fh));
+            }
+            h = hash_string(h, f.str().c_str());
+            h = hash_bytes(h, &fh, sizeof(fh));
+            return true;
+            };
+        for(const auto& f : it->second)
+        {
+            if( !add_file(f) )
+                return "";
+            // Extern crates are listed by their output path, but mrustc stores the metadata in `.hir` and the code
+            // in `.o` alongside it (the output itself is just a marker)
+            if( input_hashes.count((f + ".hir").str()) || !(Timestamp::for_file(f + ".hir") == Timestamp::infinite_past()) )
+            {
+                if( !add_file(f + ".hir") )
+                    return "";
+                if( is_linked && !add_file(f + ".o") )
+                    return "";
+            }
+        }
+
+        ::std::stringstream ss;
+        ss << ::std::hex << h;
+        return ss.str();
+    }
+    ::std::string load_fingerprint(const helpers::path& path)
+    {
+        ::std::ifstream is(path.str());
+        ::std::string   rv;
+        is >> rv;
+        return rv;
+    }
+    void save_fingerprint(const helpers::path& path, const ::std::string& fingerprint)
+    {
+        ::std::ofstream os(path.str());
+        os << fingerprint << "\n";
+    }
+}
+
 namespace {
     // Common environment variables for compiling (build scripts, 
     void push_env_common(StringListKV& env, const PackageManifest& manifest)
@@ -863,77 +1198,6 @@ bool Builder::build_target(const PackageManifest& manifest, const PackageTarget&
 
     size_t this_target_idx = (index != ~0u ? m_targets_built++ : ~0u);
 
-    // TODO: Determine if it needs re-running
-    // Rerun if:
-    // > `outfile` is missing
-    // > mrustc/minicargo is newer than `outfile`
-    // > build script has changed
-    // > any input file has changed (requires depfile from mrustc)
-    bool force_rebuild = false;
-    auto ts_result = Timestamp::for_file(outfile);
-    if( force_rebuild ) {
-        DEBUG("Building " << outfile << " - Force");
-    }
-    else if( ts_result == Timestamp::infinite_past() ) {
-        // Rebuild (missing)
-        DEBUG("Building " << outfile << " - Missing");
-    }
-    else if( !getenv("MINICARGO_IGNTOOLS") && ( ts_result < Timestamp::for_file(m_compiler_path) /*|| ts_result < Timestamp::for_file("bin/minicargo")*/ ) ) {
-        // Rebuild (older than mrustc/minicargo)
-        DEBUG("Building " << outfile << " - Older than mrustc ( " << ts_result << " < " << Timestamp::for_file(m_compiler_path) << ")");
-    }
-    else {
-        // Check dependencies. (from depfile)
-        auto depfile_ents = load_depfile(depfile);
-        auto it = depfile_ents.find(outfile);
-        bool has_new_file = false;
-        if( it != depfile_ents.end() )
-        {
-            for(const auto& f : it->second)
-            {
-                auto dep_ts = Timestamp::for_file(f);
-                if( ts_result < dep_ts )
-                {
-                    has_new_file = true;
-                    DEBUG("Rebuilding " << outfile << ", older than " << f);
-                    break;
-                }
-            }
-        }
-
-        if( !has_new_file )
-        {
-            // Don't rebuild (no need to)
-            DEBUG("Not building " << outfile << " - not out of date");
-            return true;
-        }
-    }
-
-    for(const auto& cmd : manifest.build_script_output().pre_build_commands)
-    {
-        // TODO: Run commands specified by build script (override)
-        TODO("Run command `" << cmd << "` from build script override");
-    }
-
-    {
-#ifndef DISABLE_MULTITHREAD
-        ::std::lock_guard<::std::mutex> lh { s_cout_mutex };
-#endif
-        set_console_colour(std::cout, TerminalColour::Green);
-        // TODO: Determine what number and total targets there are
-        if( index != ~0u ) {
-            //::std::cout << "(" << index << "/" << m_total_targets << ") ";
-            ::std::cout << "(" << this_target_idx << "/" << m_total_targets << ") ";
-        }
-        ::std::cout << "BUILDING ";
-        if(target.m_name != manifest.name())
-            ::std::cout << target.m_name << " from ";
-        ::std::cout << manifest.name() << " v" << manifest.version();
-        if( !manifest.active_features().empty() )
-            ::std::cout << " with features [" << manifest.active_features() << "]";
-        set_console_colour(std::cout, TerminalColour::Default);
-        ::std::cout << ::std::endl;
-    }
     StringList  args;
     args.push_back(::helpers::path(manifest.manifest_path()).parent() / ::helpers::path(target.m_path));
     args.push_back("-o"); args.push_back(outfile);
@@ -977,6 +1241,27 @@ bool Builder::build_target(const PackageManifest& manifest, const PackageTarget&
     {
         args.push_back("-C"); args.push_back("codegen-type=monomir");
     }
+    if( m_opts.emit_timings && !is_rustc )
+    {
+        args.push_back("--timings=json");
+    }
+    // Optimisation options only apply to the target
+    // - When cross compiling, host crates (build dependencies, proc macros) are only run during the build
+    if( !is_for_host || m_opts.target_name == nullptr )
+    {
+        if( m_opts.lto )
+        {
+            args.push_back("-C"); args.push_back("lto");
+        }
+        if( m_opts.profile_generate_dir.is_valid() )
+        {
+            args.push_back("-C"); args.push_back(format("profile-generate=", m_opts.profile_generate_dir));
+        }
+        if( m_opts.profile_use_dir.is_valid() )
+        {
+            args.push_back("-C"); args.push_back(format("profile-use=", m_opts.profile_use_dir));
+        }
+    }
 
     for(const auto& d : m_opts.lib_search_dirs)
     {
@@ -1074,37 +1359,90 @@ bool Builder::build_target(const PackageManifest& manifest, const PackageTarget&
     }
     push_env_common(env, manifest);
 
+    // Rerun if the output is missing, or the fingerprint (compiler, arguments, environment, and the content of
+    // all inputs listed in the depfile from the last build) has changed.
+    // - Content is used instead of timestamps, so touching files (or switching branches and back, or rebuilding
+    //   mrustc without changes) doesn't force a rebuild.
+    auto fingerprint_file = outfile + ".fingerprint";
+    bool is_linked = strcmp(crate_type, "rlib") != 0;
+    // NOTE: Always calculated, as this also records the content of the known inputs before the build
+    InputHashes input_hashes;
+    auto fingerprint = calculate_fingerprint(m_compiler_path, args, env, outfile, depfile, is_linked, input_hashes);
+    if( Timestamp::for_file(outfile) == Timestamp::infinite_past() ) {
+        DEBUG("Building " << outfile << " - Missing");
+    }
+    else {
+        if( fingerprint != "" && fingerprint == load_fingerprint(fingerprint_file) )
+        {
+            // Don't rebuild (no need to)
+            DEBUG("Not building " << outfile << " - fingerprint unchanged");
+            return true;
+        }
+        DEBUG("Building " << outfile << " - Fingerprint changed");
+    }
+
+    for(const auto& cmd : manifest.build_script_output().pre_build_commands)
+    {
+        // TODO: Run commands specified by build script (override)
+        TODO("Run command `" << cmd << "` from build script override");
+    }
+
+    {
+#ifndef DISABLE_MULTITHREAD
+        ::std::lock_guard<::std::mutex> lh { s_cout_mutex };
+#endif
+        set_console_colour(std::cout, TerminalColour::Green);
+        // TODO: Determine what number and total targets there are
+        if( index != ~0u ) {
+            //::std::cout << "(" << index << "/" << m_total_targets << ") ";
+            ::std::cout << "(" << this_target_idx << "/" << m_total_targets << ") ";
+        }
+        ::std::cout << "BUILDING ";
+        if(target.m_name != manifest.name())
+            ::std::cout << target.m_name << " from ";
+        ::std::cout << manifest.name() << " v" << manifest.version();
+        if( !manifest.active_features().empty() )
+            ::std::cout << " with features [" << manifest.active_features() << "]";
+        set_console_colour(std::cout, TerminalColour::Default);
+        ::std::cout << ::std::endl;
+    }
     // TODO: If emitting command files (i.e. cross-compiling), concatenate the contents of `outfile + ".sh"` onto a
     // master file.
     // - Will probably want to do this as a final stage after building everything.
-    return this->spawn_process_mrustc(args, ::std::move(env), outfile + "_dbg.txt");
+    // Remove the old fingerprint first, so a failed build is never considered up to date
+    remove(fingerprint_file.str().c_str());
+    auto start_time = ::std::chrono::steady_clock::now();
+    auto start_ts = Timestamp::now();
+    bool ok = this->spawn_process_mrustc(args, env, outfile + "_dbg.txt");
+    s_file_hashes.invalidate(outfile);
+    s_file_hashes.invalidate(outfile + ".hir");
+    s_file_hashes.invalidate(outfile + ".o");
+    if( !ok )
+    {
+        return false;
+    }
+    // Using the new depfile (the set of inputs may have changed)
+    save_fingerprint(fingerprint_file, calculate_fingerprint(m_compiler_path, args, env, outfile, depfile, is_linked, input_hashes, &start_ts));
+    // Record how long libraries took, for scheduling the next build
+    if( index != ~0u )
+    {
+        auto duration = ::std::chrono::duration_cast<::std::chrono::milliseconds>(::std::chrono::steady_clock::now() - start_time);
+        m_build_times.record(this->get_build_time_key(manifest, is_for_host), static_cast<unsigned long>(duration.count()));
+    }
+    return true;
 }
 ::helpers::path Builder::build_build_script(const PackageManifest& manifest, bool is_for_host, bool* out_is_rebuilt) const
 {
     // - Output dir is the same as the library.
     auto outfile = this->get_output_dir(is_for_host) / get_build_script_out(manifest) + "_run" EXESUF;
-
-    auto ts_result = Timestamp::for_file(outfile);
-    if( ts_result == Timestamp::infinite_past() ) {
-        DEBUG("Building " << outfile << " - Missing");
-    }
-    else if( !getenv("MINICARGO_IGNTOOLS") && (ts_result < Timestamp::for_file(m_compiler_path)) ) {
-        // Rebuild (older than mrustc/minicargo)
-        DEBUG("Building " << outfile << " - Older than mrustc ( " << ts_result << " < " << Timestamp::for_file(m_compiler_path) << ")");
-    }
-    else
-    {
-        *out_is_rebuilt = false;
-        return outfile;
-    }
-
-    // TODO: Load+check a depfile (requires mrustc to emit one)
+    auto depfile = outfile + ".d";
 
     StringList  args;
     args.push_back( ::helpers::path(manifest.manifest_path()).parent() / ::helpers::path(manifest.build_script()) );
     args.push_back("--crate-name"); args.push_back("build");
     args.push_back("--crate-type"); args.push_back("bin");
     args.push_back("-o"); args.push_back(outfile);
+    args.push_back("-C"); args.push_back(format("emit-depfile=",depfile));
     args.push_back("-L"); args.push_back(this->get_output_dir(true).str()); // NOTE: Forces `is_for_host` to true here.
     if( true )
     {
@@ -1154,8 +1492,29 @@ bool Builder::build_target(const PackageManifest& manifest, const PackageTarget&
     // TODO: If there's any dependencies marked as `links = foo` then grab `DEP_FOO_<varname>` from its metadata
     // (build script output)
 
-    if( this->spawn_process_mrustc(args, ::std::move(env), outfile + "_dbg.txt") )
+    // Same rules as `build_target`, rebuild if missing or the fingerprint has changed
+    auto fingerprint_file = outfile + ".fingerprint";
+    InputHashes input_hashes;
+    auto fingerprint = calculate_fingerprint(m_compiler_path, args, env, outfile, depfile, /*is_linked=*/true, input_hashes);
+    if( Timestamp::for_file(outfile) == Timestamp::infinite_past() ) {
+        DEBUG("Building " << outfile << " - Missing");
+    }
+    else {
+        if( fingerprint != "" && fingerprint == load_fingerprint(fingerprint_file) )
+        {
+            *out_is_rebuilt = false;
+            return outfile;
+        }
+        DEBUG("Building " << outfile << " - Fingerprint changed");
+    }
+
+    remove(fingerprint_file.str().c_str());
+    auto start_ts = Timestamp::now();
+    bool ok = this->spawn_process_mrustc(args, env, outfile + "_dbg.txt");
+    s_file_hashes.invalidate(outfile);
+    if( ok )
     {
+        save_fingerprint(fingerprint_file, calculate_fingerprint(m_compiler_path, args, env, outfile, depfile, /*is_linked=*/true, input_hashes, &start_ts));
         *out_is_rebuilt = true;
         return outfile;
     }
@@ -1300,7 +1659,7 @@ bool Builder::build_library(const PackageManifest& manifest, bool is_for_host, s
 
     return this->build_target(manifest, manifest.get_library(), is_for_host, index);
 }
-bool Builder::spawn_process_mrustc(const StringList& args, StringListKV env, const ::helpers::path& logfile) const
+bool Builder::spawn_process_mrustc(const StringList& args, const StringListKV& env, const ::helpers::path& logfile) const
 {
     //env.push_back("MRUSTC_DEBUG", "");
     auto rv = spawn_process(m_compiler_path.str().c_str(), args, env, logfile);
@@ -1573,6 +1932,57 @@ bool spawn_process(const char* exe_name, const StringList& args, const StringLis
     return true;
 }
 
+BuildTimes::BuildTimes(::helpers::path path):
+    m_path(::std::move(path)),
+    m_changed(false)
+{
+    // Format: One `<crate name and suffix> <milliseconds>` pair per line
+    ::std::ifstream is(m_path.str());
+    ::std::string   key;
+    unsigned long   duration_ms;
+    while( is >> key >> duration_ms )
+    {
+        m_times[key] = duration_ms;
+    }
+}
+unsigned long BuildTimes::get(const ::std::string& key) const
+{
+#ifndef DISABLE_MULTITHREAD
+    ::std::lock_guard<::std::mutex> lh { m_lock };
+#endif
+    auto it = m_times.find(key);
+    return it != m_times.end() ? it->second : 0;
+}
+void BuildTimes::record(const ::std::string& key, unsigned long duration_ms)
+{
+#ifndef DISABLE_MULTITHREAD
+    ::std::lock_guard<::std::mutex> lh { m_lock };
+#endif
+    // Zero is used for "unknown"
+    m_times[key] = ::std::max(duration_ms, 1ul);
+    m_changed = true;
+}
+void BuildTimes::save() const
+{
+    if( !m_changed )
+        return ;
+    ::std::ofstream os(m_path.str());
+    for(const auto& e : m_times)
+    {
+        os << e.first << " " << e.second << "\n";
+    }
+}
+
+Timestamp Timestamp::now()
+{
+#if _WIN32
+    FILETIME    out;
+    GetSystemTimeAsFileTime(&out);
+    return Timestamp { out };
+#else
+    return Timestamp { time(nullptr) };
+#endif
+}
 Timestamp Timestamp::for_file(const ::helpers::path& path)
 {
 #if _WIN32
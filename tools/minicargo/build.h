@@ -20,6 +20,10 @@ struct BuildOptions
     ::helpers::path build_script_overrides;
     ::std::vector<::helpers::path>  lib_search_dirs;
     bool emit_mmir = false;
+    bool emit_timings = false;  // Pass `--timings=json` to mrustc (reports are written next to each crate's output)
+    bool lto = false;   // Pass `-C lto` to the compiler
+    ::helpers::path profile_generate_dir;   // If valid, pass `-C profile-generate`
+    ::helpers::path profile_use_dir;    // If valid, pass `-C profile-use`
     const char* target_name = nullptr;  // if null, host is used
     enum class Mode {
         /// Build the binary/library
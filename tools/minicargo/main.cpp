@@ -38,6 +38,15 @@ struct ProgramOptions
     // Emit Monomorphised MIR instead of C
     bool emit_mmir = false;
 
+    // Have mrustc write a per-crate timing report (`--timings=json`)
+    bool emit_timings = false;
+
+    // Build with link-time optimisation
+    bool lto = false;
+    // Profile-guided optimisation: directory to write profile data to (instrumented build), or to read it from
+    const char* profile_generate_dir = nullptr;
+    const char* profile_use_dir = nullptr;
+
     // Target name (if null, defaults to host)
     const char* target = nullptr;
 
@@ -221,6 +230,13 @@ int main(int argc, const char* argv[])
         build_opts.output_dir = opts.output_directory ? ::helpers::path(opts.output_directory) : ::helpers::path("output");
         build_opts.lib_search_dirs.reserve(opts.lib_search_dirs.size());
         build_opts.emit_mmir = opts.emit_mmir;
+        build_opts.emit_timings = opts.emit_timings;
+        build_opts.lto = opts.lto;
+        // The instrumented program writes the profile relative to its own working directory, so make it absolute
+        if( opts.profile_generate_dir )
+            build_opts.profile_generate_dir = ::helpers::path(opts.profile_generate_dir).to_absolute();
+        if( opts.profile_use_dir )
+            build_opts.profile_use_dir = ::helpers::path(opts.profile_use_dir).to_absolute();
         build_opts.target_name = opts.target;
         for(const auto* d : opts.lib_search_dirs)
             build_opts.lib_search_dirs.push_back( ::helpers::path(d) );
@@ -314,6 +330,9 @@ int ProgramOptions::parse(int argc, const char* argv[])
                 if( ::std::strcmp(arg, "emit-mmir") == 0 ) {
                     this->emit_mmir = true;
                 }
+                else if( ::std::strcmp(arg, "timings") == 0 ) {
+                    this->emit_timings = true;
+                }
                 else {
                     ::std::cerr << "Unknown debug option -Z " << arg << ::std::endl;
                     return 1;
@@ -398,6 +417,23 @@ int ProgramOptions::parse(int argc, const char* argv[])
             else if( ::std::strcmp(arg, "--test") == 0 ) {
                 this->test = true;
             }
+            else if( ::std::strcmp(arg, "--lto") == 0 ) {
+                this->lto = true;
+            }
+            else if( ::std::strcmp(arg, "--profile-generate") == 0 ) {
+                if(i+1 == argc) {
+                    ::std::cerr << "Flag " << arg << " takes an argument" << ::std::endl;
+                    return 1;
+                }
+                this->profile_generate_dir = argv[++i];
+            }
+            else if( ::std::strcmp(arg, "--profile-use") == 0 ) {
+                if(i+1 == argc) {
+                    ::std::cerr << "Flag " << arg << " takes an argument" << ::std::endl;
+                    return 1;
+                }
+                this->profile_use_dir = argv[++i];
+            }
             else {
                 ::std::cerr << "Unknown flag " << arg << ::std::endl;
                 return 1;
@@ -410,6 +446,11 @@ int ProgramOptions::parse(int argc, const char* argv[])
         usage();
         exit(1);
     }
+    if( this->profile_generate_dir && this->profile_use_dir )
+    {
+        ::std::cerr << "--profile-generate and --profile-use can't be used together" << ::std::endl;
+        return 1;
+    }
 
     return 0;
 }
@@ -437,5 +478,8 @@ void ProgramOptions::help() const
         << "-n                       : Don't build any packages, just list the packages that would be built\n"
         << "--no-default-features    : \n"
         << "--features <list>        : \n"
+        << "--lto                    : Build with link-time optimisation\n"
+        << "--profile-generate <dir> : Build an instrumented binary that writes profile data to <dir> when run\n"
+        << "--profile-use <dir>      : Optimise using the profile data in <dir> (from a `--profile-generate` build)\n"
         ;
 }